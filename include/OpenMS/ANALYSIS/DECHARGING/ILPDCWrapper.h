@@ -61,19 +61,19 @@ public:
     /// If the input feature map is empty, a warning is issued and -1 is returned.
     /// @return value of objective function
     /// and @p pairs will have all realized edges set to "active"
-    DoubleReal compute(const FeatureMap<> fm, PairsType & pairs, Size verbose_level) const;
+    DoubleReal compute(const FeatureMap<> & fm, PairsType & pairs, Size verbose_level) const;
 
 private:
 
     /// slicing the problem into subproblems
-    DoubleReal computeSlice_(const FeatureMap<> fm,
+    DoubleReal computeSlice_(const FeatureMap<> & fm,
                              PairsType & pairs,
                              const PairsIndex margin_left,
                              const PairsIndex margin_right,
                              const Size verbose_level) const;
 
     /// slicing the problem into subproblems
-    DoubleReal computeSliceOld_(const FeatureMap<> fm,
+    DoubleReal computeSliceOld_(const FeatureMap<> & fm,
                                 PairsType & pairs,
                                 const PairsIndex margin_left,
                                 const PairsIndex margin_right,
@@ -82,6 +82,9 @@ private:
     /// calculate a score for the i_th edge
     DoubleReal getLogScore_(const PairsType::value_type & pair, const FeatureMap<> & fm) const;
 
+    /// find the representative of feature @p f in the union-find structure @p parent (compresses the path on the way)
+    Size findRoot_(std::vector<Size> & parent, Size f) const;
+
     typedef Map<String, std::set<Size> > FeatureType_;
 
     // add another charge annotation variant for a feature
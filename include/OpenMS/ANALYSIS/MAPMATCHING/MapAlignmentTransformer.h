@@ -73,6 +73,9 @@ public:
     /// Applies the <i>given</i> transformations to a single peak map
     static void transformSinglePeakMap(MSExperiment<> & msexp, const TransformationDescription & trafo);
 
+    /// Applies the <i>given</i> transformations to a single chromatogram
+    static void transformSingleChromatogram(MSChromatogram<ChromatogramPeak> & chromatogram, const TransformationDescription & trafo);
+
     /// Applies the <i>given</i> transformations to a single feature map
     static void transformSingleFeatureMap(FeatureMap<> & fmap, const TransformationDescription & trafo);
 
@@ -90,6 +90,14 @@ public:
     */
     DoubleReal apply(DoubleReal value) const;
 
+    /**
+         @brief Applies the transformation to all @p values (in place).
+
+         Equivalent to calling apply() on every value, but cheaper (especially for sorted values).
+         Like apply(), this is safe to call from several threads.
+    */
+    void apply(std::vector<DoubleReal> & values) const;
+
     /// Gets the type of the fitted model
     const String & getModelType() const;
 
@@ -40,8 +40,48 @@
 #include <gsl/gsl_bspline.h>
 #include <gsl/gsl_interp.h>
 
+#include <vector>
+
 namespace OpenMS
 {
+  namespace Internal
+  {
+    /**
+         @brief Piecewise cubic polynomial, used as a compiled look-up table by the non-linear transformation models
+
+         On the segment [x_i, x_i+1] the value is a_i + b_i * d + c_i * d^2 + e_i * d^3 with d = x - x_i.
+         Evaluation only reads the table, so it is safe to call from several threads.
+    */
+    class OPENMS_DLLAPI PiecewiseCubic
+    {
+public:
+      /// Constructor (empty table)
+      PiecewiseCubic();
+
+      /// Sets the breakpoints and the four coefficients (a, b, c, e) of each of the breakpoints.size() - 1 segments
+      void setSegments(const std::vector<double> & breakpoints, const std::vector<double> & coefficients);
+
+      /// Removes all segments
+      void clear();
+
+      /// Returns whether the table has no segments
+      bool empty() const;
+
+      /**
+           @brief Evaluates the polynomial at @p value (which has to be inside the first and the last breakpoint)
+
+           @p segment is used as a starting guess and updated to the segment of @p value, which makes the evaluation of sorted values cheap.
+      */
+      double evaluate(const double value, Size & segment) const;
+
+protected:
+      /// Breakpoints (segment boundaries)
+      std::vector<double> breakpoints_;
+      /// Four coefficients per segment
+      std::vector<double> coefficients_;
+    };
+  }
+
   /**
        @brief Base class for transformation models
 
@@ -74,6 +114,19 @@ public:
       return value;
     }
 
+    /**
+         @brief Evaluates the model at all values in the range [@p begin, @p end) (in place)
+
+         Evaluation is cheapest if the values are sorted. Like the single-value version, this is safe to call from several threads.
+    */
+    virtual void evaluate(std::vector<DoubleReal>::iterator begin, std::vector<DoubleReal>::iterator end) const
+    {
+      for (; begin != end; ++begin)
+      {
+        *begin = evaluate(*begin);
+      }
+    }
+
     /// Gets the (actual) parameters
     void getParameters(Param & params) const
     {
@@ -118,6 +171,9 @@ public:
     /// Evaluates the model at the given value
     virtual DoubleReal evaluate(const DoubleReal value) const;
 
+    /// Evaluates the model at all values in the range [@p begin, @p end) (in place)
+    virtual void evaluate(std::vector<DoubleReal>::iterator begin, std::vector<DoubleReal>::iterator end) const;
+
     using TransformationModel::getParameters;
 
     /// Gets the "real" parameters
@@ -150,6 +206,8 @@ protected:
 
        Different types of interpolation (controlled by the parameter @p interpolation_type) are supported: "linear", "polynomial", "cspline", and "akima". Note that the number of required data points may differ between types.
 
+       The piecewise types ("linear", "cspline", "akima") are compiled into a table of cubic polynomials when the model is constructed, which is checked against the GSL interpolation. Evaluation is thread-safe for all types.
+
        @ingroup MapAlignment
   */
   class OPENMS_DLLAPI TransformationModelInterpolated :
@@ -170,16 +228,25 @@ public:
     /// Evaluates the model at the given value
     DoubleReal evaluate(const DoubleReal value) const;
 
+    /// Evaluates the model at all values in the range [@p begin, @p end) (in place)
+    void evaluate(std::vector<DoubleReal>::iterator begin, std::vector<DoubleReal>::iterator end) const;
+
     /// Gets the default parameters
     static void getDefaultParameters(Param & params);
 
 protected:
+    /// Evaluates the model at @p value, @p segment and @p acc speed up the look-up of consecutive values
+    DoubleReal evaluate_(const DoubleReal value, Size & segment, gsl_interp_accel & acc) const;
+
+    /// Compiles the interpolation into @p table_ (stays empty if the type is not piecewise cubic)
+    void compileTable_(const String & interpolation_type);
+
     /// Data coordinates
     std::vector<double> x_, y_;
     /// Number of data points
     size_t size_;
-    /// Look-up accelerator
-    gsl_interp_accel * acc_;
+    /// Compiled interpolation (empty for "polynomial")
+    Internal::PiecewiseCubic table_;
     /// Interpolation function
     gsl_interp * interp_;
     /// Linear model for extrapolation
@@ -194,6 +261,8 @@ protected:
 
        Positioning of the breakpoints is controlled by the parameter @p break_positions. Valid choices are "uniform" (equidistant spacing on the data range) and "quantiles" (equal numbers of data points in every interval).
 
+       After fitting, the spline is compiled into a table of cubic polynomials (one per interval between breakpoints), which is checked against the GSL evaluation. Evaluation is thread-safe.
+
        @ingroup MapAlignment
   */
   class OPENMS_DLLAPI TransformationModelBSpline :
@@ -213,6 +282,9 @@ public:
     /// Evaluates the model at the given value
     DoubleReal evaluate(const DoubleReal value) const;
 
+    /// Evaluates the model at all values in the range [@p begin, @p end) (in place)
+    void evaluate(std::vector<DoubleReal>::iterator begin, std::vector<DoubleReal>::iterator end) const;
+
     /// Gets the default parameters
     static void getDefaultParameters(Param & params);
 
@@ -234,6 +306,15 @@ protected:
     void computeLinear_(const double pos, double & slope, double & offset,
                         double & sd_err);
 
+    /// Compiles the fitted spline into @p table_
+    void compileTable_();
+
+    /// Evaluates the spline with GSL (not thread-safe, uses the shared workspace)
+    double evaluateSpline_(const double value) const;
+
+    /// Evaluates the model at @p value, @p segment speeds up the look-up of consecutive values
+    DoubleReal evaluate_(const DoubleReal value, Size & segment) const;
+
     /// Vectors for B-spline computation
     gsl_vector * x_, * y_, * w_, * bsplines_, * coeffs_;
     /// Covariance matrix
@@ -248,6 +329,8 @@ protected:
     double slope_min_, slope_max_, offset_min_, offset_max_;
     /// Fitting errors of linear extrapolation
     double sd_err_left_, sd_err_right_;
+    /// Compiled spline (empty if the compilation failed the accuracy check)
+    Internal::PiecewiseCubic table_;
   };
 
 } // end of namespace OpenMS
@@ -36,6 +36,7 @@
 #define OPENMS_ANALYSIS_OPENSWATH_CHROMATOGRAMEXTRACTOR_H
 
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/PeakArrayExperiment.h>
 #include <OpenMS/ANALYSIS/TARGETED/TargetedExperiment.h>
 
 // move to TOPPTool
@@ -79,103 +80,36 @@ public:
     void extractChromatograms(const ExperimentT& input, ExperimentT& output, OpenMS::TargetedExperiment& transition_exp, double extract_window, bool ppm,
                               TransformationDescription trafo, double rt_extraction_window, String filter)
     {
-
-      // invert the trafo because we want to transform nRT values to "real" RT values
-      trafo.invert();
-
-      Size input_size = input.size();
-      if (input_size < 1)
+      if (input.size() < 1)
       {
         return;
       }
       SpectrumSettings settings = input[0];
-      int used_filter = -1;
-      if (filter == "tophat")
-      {
-        used_filter = 1;
-      }
-      else if (filter == "bartlett")
-      {
-        used_filter = 2;
-      }
-      else
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
-                                         "Filter either needs to be tophat or bartlett");
-      }
-
-      // Store the peptide retention times in an intermediate map
-      PeptideRTMap_.clear();
-      for (Size i = 0; i < transition_exp.getPeptides().size(); i++)
-      {
-        const TargetedExperiment::Peptide& pep = transition_exp.getPeptides()[i];
-        if (pep.rts.empty() || pep.rts[0].getCVTerms()["MS:1000896"].empty())
-        {
-          // we dont have retention times -> this is only a problem if we actually
-          // wanted to use the RT limit feature.
-          if (rt_extraction_window >= 0)
-          {
-            throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
-                                             "Error: Peptide " + pep.id + " does not have normalized retention times (term 1000896) which are necessary to perform an RT-limited extraction");
-          }
-          continue;
-        }
-        PeptideRTMap_[pep.id] = pep.rts[0].getCVTerms()["MS:1000896"][0].getValue().toString().toDouble();
-      }
-
-      // sort the transition experiment by product mass
-      // this is essential because the algorithm assumes sorted transitions!
-      transition_exp.sortTransitionsByProductMZ();
-
-      // prepare all the spectra (but leave them empty)
       std::vector<typename ExperimentT::ChromatogramType> chromatograms;
-      prepareSpectra_(settings, chromatograms, transition_exp);
-
-      //go through all spectra
-      startProgress(0, input_size, "Extracting chromatograms");
-      for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
-      {
-        setProgress(scan_idx);
-
-        if (input[scan_idx].size() == 0)
-          continue;
+      extractChromatograms_(input, input.size(), settings, chromatograms, transition_exp, extract_window, ppm, trafo, rt_extraction_window, filter);
 
-        Size peak_idx = 0;
-
-        double mz;
-        double integrated_intensity = 0;
-
-        // go through all transitions / chromatograms which are sorted by
-        // ProductMZ. We can use this to step through the spectrum and at the
-        // same time step through the transitions. We increase the peak counter
-        // until we hit the next transition and then extract the signal.
-        for (Size k = 0; k < chromatograms.size(); ++k)
-        {
-
-          double current_rt = input[scan_idx].getRT();
-          if (outsideExtractionWindow_(transition_exp.getTransitions()[k], current_rt, trafo, rt_extraction_window))
-          {
-            continue;
-          }
-
-          typename ExperimentT::ChromatogramType::PeakType p;
-          mz = transition_exp.getTransitions()[k].getProductMZ();
+      // add all the chromatograms to the output
+      output.setChromatograms(chromatograms);
+    }
 
-          if (used_filter == 1)
-          {
-            extract_value_tophat(input[scan_idx], mz, peak_idx, integrated_intensity, extract_window, ppm);
-          }
-          else if (used_filter == 2)
-          {
-            extract_value_bartlett(input[scan_idx], mz, peak_idx, integrated_intensity, extract_window, ppm);
-          }
+    /**
+      @brief Extract chromatograms defined by the TargetedExperiment from a PeakArrayExperiment and write them to the output map
 
-          p.setRT(current_rt);
-          p.setIntensity(integrated_intensity);
-          chromatograms[k].push_back(p);
-        }
+      The signal is extracted directly from the m/z and intensity arrays of @p input, no MSSpectrum is built.
+      Since PeakArrayExperiment keeps no spectrum meta data, the meta data of the chromatograms
+      (precursor isolation window, instrument settings, ...) is taken from @p settings, usually the settings of the first spectrum
+      (see MSDataPeakArrayConsumer).
+    */
+    template <typename ExperimentT>
+    void extractChromatograms(const PeakArrayExperiment& input, ExperimentT& output, OpenMS::TargetedExperiment& transition_exp, double extract_window, bool ppm,
+                              TransformationDescription trafo, double rt_extraction_window, String filter, const SpectrumSettings& settings)
+    {
+      if (input.size() < 1)
+      {
+        return;
       }
-      endProgress();
+      std::vector<typename ExperimentT::ChromatogramType> chromatograms;
+      extractChromatograms_(PeakArrayAccess_(input), input.size(), settings, chromatograms, transition_exp, extract_window, ppm, trafo, rt_extraction_window, filter);
 
       // add all the chromatograms to the output
       output.setChromatograms(chromatograms);
@@ -396,6 +330,165 @@ public:
 
 private:
 
+    /// One spectrum of a PeakArrayExperiment, with the spectrum interface used by the extraction
+    class PeakArraySpectrum_
+    {
+public:
+      PeakArraySpectrum_(const PeakArrayExperiment& exp, Size index) :
+        mz_(exp.getMZArray().empty() ? 0 : &exp.getMZArray()[0] + exp.getSpectrumBegin(index)),
+        intensity_(exp.getIntensityArray().empty() ? 0 : &exp.getIntensityArray()[0] + exp.getSpectrumBegin(index)),
+        size_(exp.getSpectrumEnd(index) - exp.getSpectrumBegin(index)),
+        rt_(exp.getRT(index))
+      {
+      }
+
+      Size size() const
+      {
+        return size_;
+      }
+
+      DoubleReal getRT() const
+      {
+        return rt_;
+      }
+
+      Peak1D operator[](Size i) const
+      {
+        Peak1D p;
+        p.setMZ(mz_[i]);
+        p.setIntensity(intensity_[i]);
+        return p;
+      }
+
+private:
+      const DoubleReal* mz_;
+      const Real* intensity_;
+      Size size_;
+      DoubleReal rt_;
+    };
+
+    /// Spectrum access to a PeakArrayExperiment for extractChromatograms_()
+    class PeakArrayAccess_
+    {
+public:
+      explicit PeakArrayAccess_(const PeakArrayExperiment& exp) :
+        exp_(exp)
+      {
+      }
+
+      PeakArraySpectrum_ operator[](Size index) const
+      {
+        return PeakArraySpectrum_(exp_, index);
+      }
+
+private:
+      const PeakArrayExperiment& exp_;
+    };
+
+    /**
+      @brief Extracts the chromatograms of all transitions from the spectra of @p input
+
+      @p input is accessed like an MSExperiment: input[i] has to provide size(), getRT(), and
+      peaks with getMZ() and getIntensity(), as needed by extract_value_tophat() and extract_value_bartlett().
+    */
+    template <typename InputT, typename ChromatogramT>
+    void extractChromatograms_(const InputT& input, Size input_size, const SpectrumSettings& settings, std::vector<ChromatogramT>& chromatograms,
+                               OpenMS::TargetedExperiment& transition_exp, double extract_window, bool ppm,
+                               TransformationDescription trafo, double rt_extraction_window, const String& filter)
+    {
+
+      // invert the trafo because we want to transform nRT values to "real" RT values
+      trafo.invert();
+
+      int used_filter = -1;
+      if (filter == "tophat")
+      {
+        used_filter = 1;
+      }
+      else if (filter == "bartlett")
+      {
+        used_filter = 2;
+      }
+      else
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                         "Filter either needs to be tophat or bartlett");
+      }
+
+      // Store the peptide retention times in an intermediate map
+      PeptideRTMap_.clear();
+      for (Size i = 0; i < transition_exp.getPeptides().size(); i++)
+      {
+        const TargetedExperiment::Peptide& pep = transition_exp.getPeptides()[i];
+        if (pep.rts.empty() || pep.rts[0].getCVTerms()["MS:1000896"].empty())
+        {
+          // we dont have retention times -> this is only a problem if we actually
+          // wanted to use the RT limit feature.
+          if (rt_extraction_window >= 0)
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+                                             "Error: Peptide " + pep.id + " does not have normalized retention times (term 1000896) which are necessary to perform an RT-limited extraction");
+          }
+          continue;
+        }
+        PeptideRTMap_[pep.id] = pep.rts[0].getCVTerms()["MS:1000896"][0].getValue().toString().toDouble();
+      }
+
+      // sort the transition experiment by product mass
+      // this is essential because the algorithm assumes sorted transitions!
+      transition_exp.sortTransitionsByProductMZ();
+
+      // prepare all the spectra (but leave them empty)
+      prepareSpectra_(settings, chromatograms, transition_exp);
+
+      //go through all spectra
+      startProgress(0, input_size, "Extracting chromatograms");
+      for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+      {
+        setProgress(scan_idx);
+
+        if (input[scan_idx].size() == 0)
+          continue;
+
+        Size peak_idx = 0;
+
+        double mz;
+        double integrated_intensity = 0;
+
+        // go through all transitions / chromatograms which are sorted by
+        // ProductMZ. We can use this to step through the spectrum and at the
+        // same time step through the transitions. We increase the peak counter
+        // until we hit the next transition and then extract the signal.
+        for (Size k = 0; k < chromatograms.size(); ++k)
+        {
+
+          double current_rt = input[scan_idx].getRT();
+          if (outsideExtractionWindow_(transition_exp.getTransitions()[k], current_rt, trafo, rt_extraction_window))
+          {
+            continue;
+          }
+
+          typename ChromatogramT::PeakType p;
+          mz = transition_exp.getTransitions()[k].getProductMZ();
+
+          if (used_filter == 1)
+          {
+            extract_value_tophat(input[scan_idx], mz, peak_idx, integrated_intensity, extract_window, ppm);
+          }
+          else if (used_filter == 2)
+          {
+            extract_value_bartlett(input[scan_idx], mz, peak_idx, integrated_intensity, extract_window, ppm);
+          }
+
+          p.setRT(current_rt);
+          p.setIntensity(integrated_intensity);
+          chromatograms[k].push_back(p);
+        }
+      }
+      endProgress();
+
+    }
+
     /// This populates the chromatograms vector with empty chromatograms (but sets their meta-information)
     template <class SpectrumSettingsT, class ChromatogramT>
     void prepareSpectra_(SpectrumSettingsT& settings, std::vector<ChromatogramT>& chromatograms, OpenMS::TargetedExperiment& transition_exp)
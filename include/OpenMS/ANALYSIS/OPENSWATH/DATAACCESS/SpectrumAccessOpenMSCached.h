@@ -87,11 +87,16 @@ public:
     std::string getChromatogramNativeID(int id) const;
 
 private:
+    /// Builds the index of the cached file on first access (thread-safe)
+    void createIndex_() const;
+
     MSExperimentType meta_ms_experiment_;
     std::ifstream ifs_;
     CachedmzML cache_;
     String filename_;
     String filename_cached_;
+    /// Whether the index of the cached file has been built
+    mutable bool index_created_;
   };
 
 } //end namespace
@@ -44,6 +44,8 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/ITransition.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
 
+#include <boost/unordered_map.hpp>
+
 namespace OpenMS
 {
   /**
@@ -76,6 +78,14 @@ namespace OpenMS
     interface. Transitions are expected to be in the light transition format
     (defined in OPENSWATHALGO/DATAACCESS/TransitionExperiment.h).
 
+    The theoretical b/y ion series of the peptides and the theoretical isotope
+    patterns of the transitions can be precomputed once for a whole library
+    (see addTheoreticalIons and addTheoreticalIsotopes), otherwise they are
+    computed for every call. The scoring functions only read these tables and
+    can be called concurrently once the tables are filled. The isotope
+    patterns depend on the parameters and are removed when the parameters
+    change.
+
   @htmlinclude OpenMS_DIAScoring.parameters
 
   */
@@ -117,21 +127,44 @@ public:
     //@{
     /// Isotope scores, see class description
     void dia_isotope_scores(const std::vector<TransitionType>& transitions,
-                            SpectrumType spectrum, OpenSwath::IMRMFeature* mrmfeature, double& isotope_corr,
-                            double& isotope_overlap);
+                            const SpectrumType& spectrum, OpenSwath::IMRMFeature* mrmfeature, double& isotope_corr,
+                            double& isotope_overlap) const;
 
     /// Massdiff scores, see class description
     void dia_massdiff_score(const std::vector<TransitionType>& transitions,
-                            SpectrumType spectrum, const std::vector<double>& normalized_library_intensity,
-                            double& ppm_score, double& ppm_score_weighted);
+                            const SpectrumType& spectrum, const std::vector<double>& normalized_library_intensity,
+                            double& ppm_score, double& ppm_score_weighted) const;
 
     /// b/y ion scores
-    void dia_by_ion_score(SpectrumType spectrum, AASequence& sequence,
-                          int charge, double& bseries_score, double& yseries_score);
+    void dia_by_ion_score(const SpectrumType& spectrum, AASequence& sequence,
+                          int charge, double& bseries_score, double& yseries_score) const;
+
+    /**
+      @brief b/y ion scores using the precomputed ion series of @p peptide_ref
+
+      @exception Exception::ElementNotFound is thrown if the ion series of @p peptide_ref was not precomputed for @p charge
+    */
+    void dia_by_ion_score(const SpectrumType& spectrum, const std::string& peptide_ref,
+                          int charge, double& bseries_score, double& yseries_score) const;
 
     /// Dotproduct / Manhatten score with theoretical spectrum
-    void score_with_isotopes(SpectrumType spectrum, const std::vector<TransitionType>& transitions,
-                             double& dotprod, double& manhattan);
+    void score_with_isotopes(const SpectrumType& spectrum, const std::vector<TransitionType>& transitions,
+                             double& dotprod, double& manhattan) const;
+    //@}
+
+    ///@name Theoretical ion tables
+    //@{
+    /// Precompute the b/y ion series of @p sequence at @p charge, stored under @p peptide_ref
+    void addTheoreticalIons(const std::string& peptide_ref, AASequence& sequence, int charge);
+
+    /// Precompute the theoretical isotope patterns of the product ions of @p transitions, stored under their native ids
+    void addTheoreticalIsotopes(const std::vector<TransitionType>& transitions);
+
+    /// Returns whether the b/y ion series of @p peptide_ref was precomputed at @p charge
+    bool hasTheoreticalIons(const std::string& peptide_ref, int charge) const;
+
+    /// Removes all precomputed b/y ion series and isotope patterns
+    void clearTheoreticalTables();
     //@}
 
 private:
@@ -147,15 +180,21 @@ private:
 
     /// Subfunction of dia_isotop_scores
     void diaIsotopeScoresSub_(const std::vector<TransitionType>& transitions,
-                                SpectrumType spectrum, std::map<std::string, double>& intensities,
-                                double& isotope_corr, double& isotope_overlap);
+                                const SpectrumType& spectrum, std::map<std::string, double>& intensities,
+                                double& isotope_corr, double& isotope_overlap) const;
 
     /// retrieves intensities from MRMFeature
     /// computes a vector of relative intensities for each feature (output to intensities)
     void getFirstIsotopeRelativeIntensities_(const std::vector<TransitionType>& transitions,
                                             OpenSwath::IMRMFeature* mrmfeature,
                                             std::map<std::string, double>& intensities //experimental intensities of transitions
-                                            );
+                                            ) const;
+
+    /// counts the ions of the (sorted) ion series @p series found in @p spectrum
+    double countIonSeries_(const SpectrumType& spectrum, const std::vector<double>& series) const;
+
+    /// computes the theoretical isotope intensities of a product ion, scaled to a maximum of 1
+    void getTheoreticalIsotopes_(double product_mz, int putative_fragment_charge, std::vector<double>& intensities) const;
 
 private:
 
@@ -164,10 +203,11 @@ private:
 
       This function will try to determine whether the current peak is part of
       an isotopic pattern that does NOT have the current peak as monoisotopic
-      peak.
+      peak. The signal at (mz - 1) / charge for charge 1 to dia_nr_charges is
+      given in @p preisotopes_mz and @p preisotopes_int.
     */
-    DoubleReal largePeaksBeforeFirstIsotope_(double product_mz,
-                                            SpectrumType& spectrum, double max_ppm_diff, double main_peak);
+    DoubleReal largePeaksBeforeFirstIsotope_(double product_mz, const std::vector<double>& preisotopes_mz,
+                                            const std::vector<double>& preisotopes_int, double max_ppm_diff, double main_peak) const;
 
     /**
       @brief Compare an experimental isotope pattern to a theoretical one
@@ -175,8 +215,16 @@ private:
       This function will take an array of isotope intensities and compare them
       to the theoritcally expected ones using pearson correlation.
     */
-    DoubleReal scoreIsotopePattern_(double product_mz,
-                                   const std::vector<double>& isotopes_int, int putative_fragment_charge);
+    DoubleReal scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                   const std::vector<double>& theoretical_isotopes_int) const;
+
+    /// Precomputed b/y ion series of a peptide
+    struct TheoreticalIons
+    {
+      int charge;
+      std::vector<double> bseries;
+      std::vector<double> yseries;
+    };
 
     // Parameters
     double dia_extract_window_;
@@ -186,6 +234,11 @@ private:
     double dia_nr_isotopes_;
     double dia_nr_charges_;
 
+    /// Precomputed b/y ion series by peptide reference
+    boost::unordered_map<std::string, TheoreticalIons> theoretical_ions_;
+    /// Precomputed theoretical isotope intensities by transition native id
+    boost::unordered_map<std::string, std::vector<double> > theoretical_isotopes_;
+
   };
 }
 
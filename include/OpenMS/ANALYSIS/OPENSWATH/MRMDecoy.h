@@ -82,6 +82,13 @@ namespace OpenMS
   Optionally, the m/z values are corrected to reflect the theoretical value rather
   than the experimental value in the library.
 
+  The peptides are independent of each other and are processed in parallel if
+  OpenMP is available. The ion series of each target and decoy peptide are
+  computed once and are used both for the decoy transitions and for the
+  correction of the target masses. To keep the memory bounded for very large
+  libraries, a library can also be processed in blocks of peptides (see
+  @ref TOPP_OpenSwathDecoyGenerator, which writes each block directly to TSV).
+
  */
 
   class OPENMS_DLLAPI MRMDecoy :
@@ -133,14 +140,14 @@ public:
     /**
       @brief Selects a decoy ion from a set of ions.
     */
-    std::pair<String, DoubleReal> getDecoyIon(String ionid,
-                                              std::map<String, std::map<String, DoubleReal> >& decoy_ionseries);
+    std::pair<String, DoubleReal> getDecoyIon(const String& ionid,
+                                              const std::map<String, std::map<String, DoubleReal> >& decoy_ionseries);
 
     /**
       @brief Selects a target ion from a set of ions.
     */
     std::pair<String, double> getTargetIon(double ProductMZ, double mz_threshold,
-                                           std::map<String, std::map<String, double> > target_ionseries);
+                                           const std::map<String, std::map<String, double> >& target_ionseries);
 
     /**
       @brief Generate all ion series for an input AASequence
@@ -205,6 +212,30 @@ public:
     */
     OpenMS::TargetedExperiment::Peptide reversePeptide(
       OpenMS::TargetedExperiment::Peptide peptide);
+
+private:
+
+    /**
+      @brief Apply the decoy @p method to the peptide @p target and store the result in @p decoy
+
+      Returns 2 if the decoy is more similar to the target than @p identity_threshold, 1 otherwise.
+    */
+    int createDecoyPeptide_(const OpenMS::TargetedExperiment::Peptide& target, OpenMS::TargetedExperiment::Peptide& decoy,
+                            const String& method, const String& decoy_tag, double identity_threshold, int max_attempts);
+
+    /**
+      @brief Create the decoy transitions (and the mass corrected target transitions) for the transitions of one peptide
+
+      The references of decoy peptides with a transition closer than @p
+      similarity_threshold to its target are appended to @p exclusions.
+    */
+    void createDecoyTransitions_(const std::vector<const ReactionMonitoringTransition*>& transitions,
+                                 const AASequence& target_sequence, int target_charge,
+                                 const AASequence& decoy_sequence, int decoy_charge, bool create_decoy,
+                                 const String& method, const String& decoy_tag, double mz_threshold,
+                                 bool theoretical, double mz_shift, double similarity_threshold, double precursor_mass_shift,
+                                 TransitionVectorType& decoy_transitions, TransitionVectorType& target_transitions,
+                                 std::vector<String>& exclusions);
   };
 }
 
@@ -68,9 +68,13 @@
 
 // auxiliary
 #include <OpenMS/ANALYSIS/OPENSWATH/SpectrumAddition.h>
+#include <OpenMS/CONCEPT/ParallelExceptionHandler.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <deque>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -390,6 +394,151 @@ var_yseries_score   -0.0327896378737766
 
   };
 
+  /**
+  @brief A cache of (added up) DIA spectra
+
+  The spectra are identified by the index of the spectrum closest to the
+  peak apex, thus one cache may only be used for one SWATH map and one set of
+  spectrum addition parameters. Many peak groups elute close to each other and
+  share the same spectra, which then only need to be fetched and added once.
+
+  The slots for all spectra of the map are allocated on construction, thus
+  looking up a spectrum only locks its own slot. When more than @p capacity
+  spectra are stored, the one inserted first is dropped.
+
+  All methods may be called concurrently from multiple threads.
+  */
+  class AddedSpectraCache
+  {
+  public:
+
+    /// Constructor for a map with @p nr_spectra spectra, @p capacity is the maximal number of spectra held
+    explicit AddedSpectraCache(Size nr_spectra, Size capacity = 512) :
+      spectra_(nr_spectra),
+      capacity_(capacity)
+    {
+#ifdef _OPENMP
+      for (Size i = 0; i < NR_LOCKS; i++)
+      {
+        omp_init_lock(&locks_[i]);
+      }
+#endif
+    }
+
+    /// Destructor
+    ~AddedSpectraCache()
+    {
+#ifdef _OPENMP
+      for (Size i = 0; i < NR_LOCKS; i++)
+      {
+        omp_destroy_lock(&locks_[i]);
+      }
+#endif
+    }
+
+    /// Returns true and sets @p spectrum if the spectrum for @p index is cached
+    bool get(int index, OpenSwath::SpectrumPtr& spectrum)
+    {
+      if (index < 0 || index >= (int)spectra_.size())
+      {
+        return false;
+      }
+      OpenSwath::SpectrumPtr result;
+      lock_(index);
+      result = spectra_[index];
+      unlock_(index);
+      if (!result)
+      {
+        return false;
+      }
+      spectrum = result;
+      return true;
+    }
+
+    /// Stores @p spectrum for @p index, dropping the oldest spectrum if the cache is full
+    void insert(int index, OpenSwath::SpectrumPtr spectrum)
+    {
+      if (capacity_ == 0 || index < 0 || index >= (int)spectra_.size())
+      {
+        return;
+      }
+#ifdef _OPENMP
+#pragma omp critical (AddedSpectraCache_insert)
+#endif
+      {
+        // another thread may have computed the same spectrum in the meantime
+        lock_(index);
+        bool is_new = !spectra_[index];
+        if (is_new)
+        {
+          spectra_[index] = spectrum;
+        }
+        unlock_(index);
+
+        if (is_new)
+        {
+          order_.push_back(index);
+          if (order_.size() > capacity_)
+          {
+            int oldest = order_.front();
+            order_.pop_front();
+            lock_(oldest);
+            spectra_[oldest].reset();
+            unlock_(oldest);
+          }
+        }
+      }
+    }
+
+    /// Returns the number of cached spectra
+    Size size() const
+    {
+      Size result = 0;
+#ifdef _OPENMP
+#pragma omp critical (AddedSpectraCache_insert)
+#endif
+      result = order_.size();
+      return result;
+    }
+
+  private:
+
+    /// not implemented (holds locks)
+    AddedSpectraCache(const AddedSpectraCache&);
+    /// not implemented (holds locks)
+    AddedSpectraCache& operator=(const AddedSpectraCache&);
+
+    void lock_(int index)
+    {
+#ifdef _OPENMP
+      omp_set_lock(&locks_[index % NR_LOCKS]);
+#else
+      (void)index;
+#endif
+    }
+
+    void unlock_(int index)
+    {
+#ifdef _OPENMP
+      omp_unset_lock(&locks_[index % NR_LOCKS]);
+#else
+      (void)index;
+#endif
+    }
+
+    /// the slots are protected by a fixed number of locks (slot index modulo NR_LOCKS)
+    enum {NR_LOCKS = 64};
+
+    /// one slot per spectrum of the map (empty if not cached)
+    std::vector<OpenSwath::SpectrumPtr> spectra_;
+    /// cached indices, in the order they were inserted
+    std::deque<int> order_;
+    Size capacity_;
+#ifdef _OPENMP
+    omp_lock_t locks_[NR_LOCKS];
+#endif
+  };
+
   /**
   @brief A class that calls the scoring routines
   */
@@ -402,20 +551,25 @@ var_yseries_score   -0.0327896378737766
     int add_up_spectra_;
     DoubleReal spacing_for_spectra_resampling_;
     OpenSwath_Scores_Usage su_;
+    AddedSpectraCache* spectra_cache_;
 
   public:
 
     /**
     @brief Initialize the scoring object
+
+    If @p spectra_cache is given, the (added) DIA spectra are looked up there
+    first. It has to belong to the SWATH map later passed to calculateDIAScores.
     */
     void initialize(DoubleReal rt_normalization_factor_,
       int add_up_spectra_, DoubleReal spacing_for_spectra_resampling_,
-      OpenSwath_Scores_Usage & su_)
+      OpenSwath_Scores_Usage & su_, AddedSpectraCache* spectra_cache = 0)
     {
       this->rt_normalization_factor_ = rt_normalization_factor_;
       this->add_up_spectra_ = add_up_spectra_;
       this->spacing_for_spectra_resampling_ = spacing_for_spectra_resampling_;
       this->su_ = su_;
+      this->spectra_cache_ = spectra_cache;
     }
 
     /** @brief Score a single peakgroup in a chromatogram using only chromatographic properties.
@@ -541,10 +695,17 @@ var_yseries_score   -0.0327896378737766
       diascoring.dia_massdiff_score(transitions, (*spectrum), normalized_library_intensity,
           scores.massdev_score, scores.weighted_massdev_score);
 
-      // Presence of b/y series score
-      OpenMS::AASequence aas;
-      OpenSwathDataAccessHelper::convertPeptideToAASequence(pep, aas);
-      diascoring.dia_by_ion_score((*spectrum), aas, by_charge_state, scores.bseries_score, scores.yseries_score);
+      // Presence of b/y series score (use the precomputed ion series if available)
+      if (diascoring.hasTheoreticalIons(pep.id, by_charge_state))
+      {
+        diascoring.dia_by_ion_score((*spectrum), pep.id, by_charge_state, scores.bseries_score, scores.yseries_score);
+      }
+      else
+      {
+        OpenMS::AASequence aas;
+        OpenSwathDataAccessHelper::convertPeptideToAASequence(pep, aas);
+        diascoring.dia_by_ion_score((*spectrum), aas, by_charge_state, scores.bseries_score, scores.yseries_score);
+      }
 
       // FEATURE we should not punish so much when one transition is missing!
       scores.massdev_score = scores.massdev_score / transitions.size();
@@ -589,11 +750,16 @@ var_yseries_score   -0.0327896378737766
         closest_idx--;
       }
 
-      if (nr_spectra_to_add == 1)
+      OpenSwath::SpectrumPtr spectrum_;
+      if (spectra_cache_ != 0 && spectra_cache_->get(closest_idx, spectrum_))
       {
-        OpenSwath::SpectrumPtr spectrum_ = swath_map->getSpectrumById(closest_idx);
         return spectrum_;
       }
+
+      if (nr_spectra_to_add == 1)
+      {
+        spectrum_ = swath_map->getSpectrumById(closest_idx);
+      }
       else
       {
         std::vector<OpenSwath::SpectrumPtr> all_spectra;
@@ -604,9 +770,14 @@ var_yseries_score   -0.0327896378737766
           all_spectra.push_back(swath_map->getSpectrumById(closest_idx - i));
           all_spectra.push_back(swath_map->getSpectrumById(closest_idx + i));
         }
-        OpenSwath::SpectrumPtr spectrum_ = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
-        return spectrum_;
+        spectrum_ = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
+      }
+
+      if (spectra_cache_ != 0)
+      {
+        spectra_cache_->insert(closest_idx, spectrum_);
       }
+      return spectrum_;
     }
 
   };
@@ -689,6 +860,10 @@ public:
       //
       // Store the peptide retention times in an intermediate map
       prepareProteinPeptideMaps_(transition_exp);
+      if (swath_map->getNrSpectra() > 0)
+      {
+        prepareDIATables_(transition_exp);
+      }
 
       // Store the proteins from the input in the output feature map
       std::vector<ProteinHit> protein_hits;
@@ -721,26 +896,65 @@ public:
       //
       // Step 3
       //
-      // Go through all transition groups: first create consensus features, then score them
-      Size progress = 0;
-      startProgress(0, transition_group_map.size(), "picking peaks");
+      // Go through all transition groups: first create consensus features, then score them.
+      // The transition groups are picked and scored in parallel, afterwards the features are
+      // added to the output in the order of the transition groups.
+      std::vector<MRMTransitionGroupType*> transition_groups;
       for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); trgroup_it++)
       {
-
-        setProgress(++progress);
         MRMTransitionGroupType& transition_group = trgroup_it->second;
-        if (transition_group.getChromatograms().size() == 0 || transition_group.getTransitions().size() == 0)
+        if (transition_group.getChromatograms().size() > 0 && transition_group.getTransitions().size() > 0)
         {
-          continue;
+          transition_groups.push_back(&transition_group);
         }
+      }
+
+      TransformationDescription inverse_trafo = trafo;
+      inverse_trafo.invert();
+      // the slots of the spectra cache are allocated here once, the threads only look them up
+      AddedSpectraCache spectra_cache(swath_map->getNrSpectra());
+      std::vector<std::vector<Size> > scored_features(transition_groups.size());
+      // exceptions must not leave the parallel region, the one of the first failing group is rethrown afterwards
+      ParallelExceptionHandler error;
 
-        MRMTransitionGroupPicker trgroup_picker;
-        trgroup_picker.setParameters(param_.copy("TransitionGroupPicker:", true));
-        trgroup_picker.pickTransitionGroup(transition_group);
-        scorePeakgroups(trgroup_it->second, trafo, swath_map, output);
+      Size progress = 0;
+      startProgress(0, transition_groups.size(), "picking peaks");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        // the transformations and the elution model fitter keep internal state, every thread gets its own
+        TransformationDescription thread_trafo = trafo;
+        TransformationDescription thread_inverse_trafo = inverse_trafo;
+        EmgScoring emgscoring = emgscoring_;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)transition_groups.size(); ++i)
+        {
+          try
+          {
+            pickAndScoreTransitionGroup_(*transition_groups[i], thread_trafo, thread_inverse_trafo, swath_map, emgscoring, &spectra_cache, scored_features[i]);
+          }
+          catch (...)
+          {
+            error.capture(i);
+          }
 
+#ifdef _OPENMP
+#pragma omp critical (MRMFeatureFinderScoring_progress)
+#endif
+          setProgress(++progress);
+        }
       }
       endProgress();
+      error.rethrow();
+
+      for (Size i = 0; i < transition_groups.size(); ++i)
+      {
+        addScoredFeatures_(*transition_groups[i], scored_features[i], output);
+      }
 
       //output.sortByPosition(); // if the exact same order is needed
       return;
@@ -762,6 +976,26 @@ public:
         ProteinRefMap_[transition_exp.getProteins()[i].id] = &transition_exp.getProteins()[i];
       }
     }
+
+    /** @brief Precomputes the theoretical b/y ion series and isotope patterns of the library for the DIA scores.
+     *
+     * The tables are only read while scoring, which may happen from multiple
+     * threads. Without them, the DIA scores compute the theoretical values
+     * for every peak group.
+    */
+    void prepareDIATables_(OpenSwath::LightTargetedExperiment& transition_exp)
+    {
+      diascoring_.clearTheoreticalTables();
+      for (Size i = 0; i < transition_exp.getPeptides().size(); i++)
+      {
+        const PeptideType& pep = transition_exp.getPeptides()[i];
+        OpenMS::AASequence aas;
+        OpenSwathDataAccessHelper::convertPeptideToAASequence(pep, aas);
+        // the b/y series are scored at charge 1, see calculateDIAScores
+        diascoring_.addTheoreticalIons(pep.id, aas, 1);
+      }
+      diascoring_.addTheoreticalIsotopes(transition_exp.getTransitions());
+    }
     //@}
 
     /** @brief Score all peak groups of a transition group
@@ -772,10 +1006,58 @@ public:
     */
     void scorePeakgroups(MRMTransitionGroupType& transition_group, TransformationDescription & trafo,
                          OpenSwath::SpectrumAccessPtr swath_map, FeatureMap<Feature>& output)
+    {
+      TransformationDescription inverse_trafo = trafo;
+      inverse_trafo.invert();
+      std::vector<Size> scored_features;
+      scorePeakgroups_(transition_group, trafo, inverse_trafo, swath_map, emgscoring_, 0, scored_features);
+      addScoredFeatures_(transition_group, scored_features, output);
+    }
+
+    /** @brief Set the flag for strict mapping
+    */
+    void setStrictFlag(bool f)
+    {
+      strict_ = f;
+    }
+
+    /** @brief Map the chromatograms to the transitions.
+     *
+     * Map an input experiment (mzML) and transition list (TraML) onto each other
+     * when they share identifiers, e.g. if the transition id is the same as the
+     * chromatogram native id.
+    */
+    void mapExperimentToTransitionList(OpenSwath::SpectrumAccessPtr input, OpenSwath::LightTargetedExperiment& transition_exp,
+                                       TransitionGroupMapType& transition_group_map, TransformationDescription trafo, double rt_extraction_window);
+private:
+
+    /// Pick the peak groups of @p transition_group and score them (see scorePeakgroups_)
+    void pickAndScoreTransitionGroup_(MRMTransitionGroupType& transition_group, TransformationDescription & trafo,
+                                      const TransformationDescription & inverse_trafo, OpenSwath::SpectrumAccessPtr swath_map,
+                                      EmgScoring & emgscoring, AddedSpectraCache* spectra_cache, std::vector<Size>& scored_features)
+    {
+      MRMTransitionGroupPicker trgroup_picker;
+      trgroup_picker.setParameters(param_.copy("TransitionGroupPicker:", true));
+      trgroup_picker.pickTransitionGroup(transition_group);
+      scorePeakgroups_(transition_group, trafo, inverse_trafo, swath_map, emgscoring, spectra_cache, scored_features);
+    }
+
+    /** @brief Score all peak groups of a transition group without adding them to the output
+     *
+     * The indices of the scored features of @p transition_group are stored
+     * in @p scored_features. Different transition groups can be scored
+     * concurrently, as long as every thread uses its own transformations and
+     * @p emgscoring object. Unique ids are not assigned here but in
+     * addScoredFeatures_, which is not thread-safe.
+     *
+    */
+    void scorePeakgroups_(MRMTransitionGroupType& transition_group, TransformationDescription & trafo,
+                          const TransformationDescription & inverse_trafo, OpenSwath::SpectrumAccessPtr swath_map,
+                          EmgScoring & emgscoring, AddedSpectraCache* spectra_cache, std::vector<Size>& scored_features)
     {
       typedef MRMTransitionGroupType::PeakType PeakT;
       std::vector<OpenSwath::ISignalToNoisePtr> signal_noise_estimators;
-      std::vector<MRMFeature> feature_list;
+      scored_features.clear();
 
       DoubleReal sn_win_len_ = (DoubleReal)param_.getValue("TransitionGroupPicker:PeakPickerMRM:sn_win_len");
       DoubleReal sn_bin_count_ = (DoubleReal)param_.getValue("TransitionGroupPicker:PeakPickerMRM:sn_bin_count");
@@ -785,27 +1067,37 @@ public:
         signal_noise_estimators.push_back(snptr);
       }
 
-      const PeptideType* pep = PeptideRefMap_[transition_group.getTransitionGroupID()];
-      const ProteinType* prot = ProteinRefMap_[pep->protein_ref];
+      // look up without operator[], which could insert (this is called from multiple threads)
+      boost::unordered_map<std::string, const PeptideType*>::const_iterator pep_it = PeptideRefMap_.find(transition_group.getTransitionGroupID());
+      if (pep_it == PeptideRefMap_.end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          "Error: Transition group " + transition_group.getTransitionGroupID() + " does not correspond to a peptide.");
+      }
+      const PeptideType* pep = pep_it->second;
+      boost::unordered_map<std::string, const ProteinType*>::const_iterator prot_it = ProteinRefMap_.find(pep->protein_ref);
+      if (prot_it == ProteinRefMap_.end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, __PRETTY_FUNCTION__,
+          "Error: Protein " + pep->protein_ref + " of peptide " + pep->id + " is not known.");
+      }
+      const ProteinType* prot = prot_it->second;
 
       // get the expected rt value for this peptide
-      double expected_rt = pep->rt;
-      TransformationDescription newtr = trafo;
-      newtr.invert();
-      expected_rt = newtr.apply(expected_rt);
+      double expected_rt = inverse_trafo.apply(pep->rt);
 
       ChromatographicScorer scorer;
-      scorer.initialize(rt_normalization_factor_, add_up_spectra_, spacing_for_spectra_resampling_, su_);
+      scorer.initialize(rt_normalization_factor_, add_up_spectra_, spacing_for_spectra_resampling_, su_, spectra_cache);
 
       // Go through all peak groups (found MRM features) and score them
-      for (std::vector<MRMFeature>::iterator mrmfeature = transition_group.getFeaturesMuteable().begin();
-           mrmfeature != transition_group.getFeaturesMuteable().end(); mrmfeature++)
+      for (Size feature_idx = 0; feature_idx < transition_group.getFeatures().size(); ++feature_idx)
       {
-        OpenSwath::IMRMFeature* imrmfeature;
-        imrmfeature = new MRMFeatureOpenMS(*mrmfeature);
+        std::vector<MRMFeature>::iterator mrmfeature = transition_group.getFeaturesMuteable().begin() + feature_idx;
+        MRMFeatureOpenMS mrmfeature_access(*mrmfeature);
+        OpenSwath::IMRMFeature* imrmfeature = &mrmfeature_access;
 
         LOG_DEBUG << "scoring feature " << (*mrmfeature) << " == " << mrmfeature->getMetaValue("PeptideRef") <<
-        " [ expected RT " << PeptideRefMap_[mrmfeature->getMetaValue("PeptideRef")]->rt << " / " << expected_rt << " ]" <<
+        " [ expected RT " << pep->rt << " / " << expected_rt << " ]" <<
         " with " << transition_group.size()  << " nr transitions and nr chromats " << transition_group.getChromatograms().size() << std::endl;
 
         int group_size = boost::numeric_cast<int>(transition_group.size());
@@ -872,7 +1164,7 @@ public:
         if (su_.use_sn_score_) { mrmfeature->addScore("sn_ratio", scores.sn_ratio); mrmfeature->addScore("var_log_sn_score", scores.log_sn_score); }
         // TODO get it working with imrmfeature
         if (su_.use_elution_model_score_) { 
-          scores.elution_model_fit_score = emgscoring_.calcElutionFitScore((*mrmfeature), transition_group);
+          scores.elution_model_fit_score = emgscoring.calcElutionFitScore((*mrmfeature), transition_group);
           mrmfeature->addScore("var_elution_model_fit_score", scores.elution_model_fit_score); }
 
         double xx_lda_prescore = -scores.calculate_lda_prescore(scores);
@@ -925,14 +1217,12 @@ public:
         pep_id_.setIdentifier(run_identifier);
 
         mrmfeature->getPeptideIdentifications().push_back(pep_id_);
-        mrmfeature->ensureUniqueId();
         mrmfeature->setMetaValue("PrecursorMZ", transition_group.getTransitions()[0].getPrecursorMZ());
         mrmfeature->setSubordinates(mrmfeature->getFeatures()); // add all the subfeatures as subordinates
         double total_intensity = 0, total_peak_apices = 0;
         for (std::vector<Feature>::iterator sub_it = mrmfeature->getSubordinates().begin(); sub_it != mrmfeature->getSubordinates().end(); sub_it++)
         {
           if (!write_convex_hull_) {sub_it->getConvexHulls().clear(); }
-          sub_it->ensureUniqueId();
           if (sub_it->getMZ() > quantification_cutoff_)
           {
             total_intensity += sub_it->getIntensity();
@@ -942,9 +1232,28 @@ public:
         // overwrite the reported intensities with those above the m/z cutoff
         mrmfeature->setIntensity(total_intensity);
         mrmfeature->setMetaValue("peak_apices_sum", total_peak_apices);
-        feature_list.push_back((*mrmfeature));
+        scored_features.push_back(feature_idx);
+      }
+    }
 
-        delete imrmfeature;
+    /** @brief Add the scored features of a transition group to the output
+     *
+     * Assigns unique ids to the features listed in @p scored_features (and
+     * their subordinates) and adds them to @p output, ordered by quality.
+     *
+    */
+    void addScoredFeatures_(MRMTransitionGroupType& transition_group, const std::vector<Size>& scored_features, FeatureMap<Feature>& output)
+    {
+      std::vector<MRMFeature> feature_list;
+      for (Size i = 0; i < scored_features.size(); i++)
+      {
+        MRMFeature& mrmfeature = transition_group.getFeaturesMuteable()[scored_features[i]];
+        mrmfeature.ensureUniqueId();
+        for (std::vector<Feature>::iterator sub_it = mrmfeature.getSubordinates().begin(); sub_it != mrmfeature.getSubordinates().end(); sub_it++)
+        {
+          sub_it->ensureUniqueId();
+        }
+        feature_list.push_back(mrmfeature);
       }
 
       // Order by quality
@@ -958,23 +1267,6 @@ public:
       }
     }
 
-    /** @brief Set the flag for strict mapping
-    */
-    void setStrictFlag(bool f)
-    {
-      strict_ = f;
-    }
-
-    /** @brief Map the chromatograms to the transitions.
-     *
-     * Map an input experiment (mzML) and transition list (TraML) onto each other
-     * when they share identifiers, e.g. if the transition id is the same as the
-     * chromatogram native id.
-    */
-    void mapExperimentToTransitionList(OpenSwath::SpectrumAccessPtr input, OpenSwath::LightTargetedExperiment& transition_exp,
-                                       TransitionGroupMapType& transition_group_map, TransformationDescription trafo, double rt_extraction_window);
-private:
-
     /// Synchronize members with param class
     void updateMembers_();
 
@@ -991,8 +1283,8 @@ private:
     DoubleReal spacing_for_spectra_resampling_;
 
     // members
-    std::map<OpenMS::String, const PeptideType*> PeptideRefMap_;
-    std::map<OpenMS::String, const ProteinType*> ProteinRefMap_;
+    boost::unordered_map<std::string, const PeptideType*> PeptideRefMap_;
+    boost::unordered_map<std::string, const ProteinType*> ProteinRefMap_;
     OpenSwath_Scores_Usage su_;
     OpenMS::DIAScoring diascoring_;
     OpenMS::EmgScoring emgscoring_;
@@ -67,6 +67,8 @@ public:
        leaving one peptide out to find the one which results in the maximum R^2
        of a first order linear regression of the remaining ones. The datapoints
        are submitted as two vectors of doubles (x- and y-coordinates).
+       The R^2 values of the left-out regressions are computed by updating the
+       centered sums of all points, so this takes linear time.
 
       @return The position of the candidate outlier peptide as supplied by the
        vector is returned.
@@ -110,6 +112,38 @@ public:
       @return TRUE, if Chauvenet's criterion is fullfilled and the outlier can be removed.
     */
     static bool chauvenet(std::vector<double>& residuals, int pos);
+
+    /**
+      @brief This function computes the Theil-Sen estimator of a straight line
+       through a set of paired points: the slope is the median of the slopes
+       between all pairs of points, the intercept the median of y - slope * x.
+       In contrast to a least squares fit, the line is not affected by a minority
+       of outliers.
+
+      @exception Exception::UnableToFit is thrown if there are not at least two points with different x-coordinates
+    */
+    static void theil_sen(const std::vector<std::pair<double, double> >& pairs, double& slope, double& intercept);
+
+    /**
+      @brief This function removes outliers from a set of paired points using a
+       robust Theil-Sen line instead of iterative least squares fits.
+       The points are removed in the order of decreasing residuals to the robust
+       line. First, all points whose residual exceeds @p outlier_threshold times
+       the robust standard deviation of the residuals (1.4826 * median absolute
+       residual) are removed, then further points are removed until the R^2 of the
+       remaining points reaches @p rsq_limit. No points are removed below the
+       peptide coverage limit. The R^2 is updated incrementally after each removal.
+
+      @return A vector of the remaining pairs (in the original order) is returned if
+       the R^2 limit was reached without reaching the coverage limit. If the limits
+       are reached, an exception is thrown.
+
+      @exception Exception::UnableToFit is thrown if fitting cannot be performed
+    */
+    static std::vector<std::pair<double, double> > rm_outliers_theil_sen(std::vector<std::pair<double, double> >& pairs,
+                                                                         double rsq_limit,
+                                                                         double coverage_limit,
+                                                                         double outlier_threshold = 3.0);
   };
 
 }
@@ -64,6 +64,23 @@ namespace OpenSwath
                                              std::vector<double>& integratedWindowsIntensity,
                                              std::vector<double>& integratedWindowsMZ, bool remZero = false);
 
+/**
+  @brief Integrate intensities in a spectrum for a list of sorted windows
+
+  Same as integrateWindow for every center in @p windowsCenter (window of
+  size @p width), but the spectrum is traversed only once: the windows have
+  to be sorted by their center and the search for the next window start
+  continues from the start of the previous window. The output vectors have
+  the same size and order as @p windowsCenter.
+
+  @note If there is no signal in a window, mz will be set to -1 and intensity to 0
+*/
+  OPENSWATHALGO_DLLAPI void integrateSortedWindows(const OpenSwath::SpectrumPtr& spectrum, //!< [in] Spectrum
+                                                   const std::vector<double>& windowsCenter, //!< [in] sorted center locations
+                                                   double width,
+                                                   std::vector<double>& integratedWindowsIntensity,
+                                                   std::vector<double>& integratedWindowsMZ, bool centroided = false);
+
 }
 
 #endif // OPENMS_ANALYSIS_OPENSWATH_OPENSWATHALGO_DATAACCESS_SPECTRUMHELPERS_H
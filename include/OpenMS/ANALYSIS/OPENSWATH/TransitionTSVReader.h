@@ -40,8 +40,11 @@
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
 #include <fstream>
 
+#include <boost/unordered_set.hpp>
+
 namespace OpenMS
 {
 
@@ -68,6 +71,15 @@ namespace OpenMS
       PrecursorCharge (integer)
       Labelgroup (free text, e.g. heavy or light)
 
+      For large assay libraries, the TSV can be read directly into an
+      OpenSwath::LightTargetedExperiment which skips the construction of the
+      full TraML structure. The lines of the file are parsed in parallel if
+      OpenMP is available. A LightTargetedExperiment can also be stored in a
+      compact binary format in which all strings are pooled (each distinct
+      string is stored once); this file is memory-mapped when it is read back.
+      The binary format uses the native byte order and is meant as a cache
+      on the machine that created it, not as an exchange format.
+
   */
   class OPENMS_DLLAPI TransitionTSVReader :
     public ProgressLogger
@@ -111,8 +123,18 @@ private:
     /// determine separater in a CSV file and check for correct headers
     void getTSVHeader(std::string & line, char & delimiter, std::vector<std::string> header, std::map<std::string, int> & header_dict);
 
-    /// read tab or comma separated input with columns defined by their column headers only
-    void readUnstructuredTSVInput_(const char* filename, std::vector<TSVTransition>& transition_list);
+    /**
+      @brief read tab or comma separated input with columns defined by their column headers only
+
+      If @p light_exp is given, each chunk of parsed lines is converted into
+      it right away and @p transition_list stays empty, so the whole file is
+      never held as TSVTransition objects.
+    */
+    void readUnstructuredTSVInput_(const char* filename, std::vector<TSVTransition>& transition_list,
+                                   OpenSwath::LightTargetedExperiment* light_exp = 0);
+
+    /// parse a single line of TSV input, @p columns holds the position of each known column (or -1 if absent)
+    void parseTSVLine_(const std::string& line, char delimiter, const std::vector<int>& columns, Size nr_columns, Size line_nr, TSVTransition& mytransition);
 
     /// do post-processing on read input data (removing quotes etc)
     void cleanUpTransition(TSVTransition & mytransition);
@@ -129,6 +151,24 @@ private:
     void add_modification_(std::vector<TargetedExperiment::Peptide::Modification> & mods,
           int location, ResidueModification & rmod, const String & name);
 
+    /**
+      @brief append a list of TSVTransition objects to a LightTargetedExperiment
+
+      @p peptide_ids and @p protein_ids hold the ids already present in @p exp,
+      they allow to append the input chunk by chunk.
+    */
+    void TSVToLightTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp,
+                                       boost::unordered_set<std::string>& peptide_ids, boost::unordered_set<std::string>& protein_ids);
+
+    /// parse the modifications of a FullPeptideName into LightModification objects
+    void createLightModifications_(const String& full_peptide_name, std::vector<OpenSwath::LightModification>& mods);
+
+
+    /// write the header line of the TSV format
+    void writeTSVHeader_(std::ostream& os);
+
+    /// write a single transition of a TargetedExperiment as one line
+    void writeTSVTransition_(std::ostream& os, const ReactionMonitoringTransition& transition, OpenMS::TargetedExperiment& targeted_exp);
 
     /// write a TargetedExperiment to a file
     void writeTSVOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
@@ -137,12 +177,50 @@ public:
     /// Write out a targeted experiment (TraML structure) into a tsv file
     void convertTargetedExperimentToTSV(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
 
+    /// Write the header line of the tsv format to @p os
+    void writeTSVHeader(std::ostream& os);
+
+    /**
+      @brief Write the transitions of a targeted experiment to @p os (without header line)
+
+      Together with writeTSVHeader, this allows to write a large library
+      block by block without keeping all of it in memory.
+    */
+    void appendTargetedExperimentToTSV(std::ostream& os, OpenMS::TargetedExperiment& targeted_exp);
+
     /// Read in a tsv file and construct a targeted experiment (TraML structure)
     void convertTSVToTargetedExperiment(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
 
+    /// Read in a tsv file and construct a light-weight targeted experiment (OpenSwath structure)
+    void convertTSVToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp);
+
+    /**
+      @brief Write a light-weight targeted experiment into a binary library file
+
+      All strings are pooled, each distinct string is only stored once.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void convertLightTargetedExperimentToBinary(const char* filename, const OpenSwath::LightTargetedExperiment& targeted_exp);
+
+    /**
+      @brief Read a binary library file (as written by convertLightTargetedExperimentToBinary) into a light-weight targeted experiment
+
+      The file has to be written on a machine with the same byte order. The loaded
+      experiment is checked with validateTargetedExperiment.
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a valid binary library
+      @exception Exception::IllegalArgument is thrown if the loaded ids are not unique
+    */
+    void convertBinaryToLightTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp);
+
     /// Validate a TargetedExperiment (check that all ids are unique)
     void validateTargetedExperiment(OpenMS::TargetedExperiment& targeted_exp);
 
+    /// Validate a light-weight targeted experiment (check that all ids are unique)
+    void validateTargetedExperiment(const OpenSwath::LightTargetedExperiment& targeted_exp);
+
   };
 }
 
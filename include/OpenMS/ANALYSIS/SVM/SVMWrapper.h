@@ -516,6 +516,26 @@ private:
     */
     void initParameters_();
 
+    /**
+      @brief collects the (zero-based) training set indices of the support vectors of the model
+
+      For the oligo kernel, libsvm only reads the kernel matrix columns of these training samples during
+      prediction. If the support vectors cannot be determined (libsvm 2.x), all indices
+      0 ... @p number_of_training_samples - 1 are returned.
+    */
+    void getSupportVectorIndices_(Size number_of_training_samples, std::vector<Size> & indices) const;
+
+    /**
+      @brief predicts the labels for @p problem using the oligo kernel without building the full kernel matrix
+
+      Kernel rows are computed in parallel against the support vectors only, using one reusable row per thread.
+      The memory consumption is therefore independent of the number of predicted samples.
+    */
+    void predictOligo_(const svm_problem * problem, std::vector<DoubleReal> & results) const;
+
+    /// @copydoc predictOligo_(const svm_problem*, std::vector<DoubleReal>&) const
+    void predictOligo_(const SVMData & problem, std::vector<DoubleReal> & results) const;
+
     /**
       @brief This function is passed to lib svm for output control
 
@@ -0,0 +1,120 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_CONCEPT_PARALLELEXCEPTIONHANDLER_H
+#define OPENMS_CONCEPT_PARALLELEXCEPTIONHANDLER_H
+
+#include <OpenMS/CONCEPT/Types.h>
+
+namespace OpenMS
+{
+  namespace Internal
+  {
+    class CapturedException;
+  }
+
+  /**
+    @brief Keeps the first exception thrown inside an OpenMP parallel region and rethrows it afterwards
+
+    An exception must not leave an OpenMP parallel region, otherwise the program is terminated.
+    Inside the region, catch everything and hand it to capture(), together with the index of the
+    iteration. Of all captured exceptions the one with the smallest index is kept, so the same
+    exception is reported as in a serial run. After the region, rethrow() throws it again.
+
+    @code
+    ParallelExceptionHandler error;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (SignedSize i = 0; i < (SignedSize)data.size(); ++i)
+    {
+      try
+      {
+        process(data[i]);
+      }
+      catch (...)
+      {
+        error.capture(i);
+      }
+    }
+    error.rethrow();
+    @endcode
+
+    The exception is rethrown with its original type. Without C++11 support (std::exception_ptr),
+    this holds for the exceptions declared in Exception.h and the standard exceptions; other exceptions
+    derived from Exception::BaseException are rethrown as Exception::BaseException, other std::exception
+    as std::runtime_error (keeping the message), and anything else as Exception::BaseException.
+
+    @ingroup Concept
+  */
+  class OPENMS_DLLAPI ParallelExceptionHandler
+  {
+public:
+    /// Default constructor
+    ParallelExceptionHandler();
+
+    /// Destructor
+    ~ParallelExceptionHandler();
+
+    /**
+      @brief Captures the exception currently being handled
+
+      Must be called inside a catch block. Thread-safe. The exception is kept if no exception
+      with a smaller @p index was captured before.
+    */
+    void capture(SignedSize index);
+
+    /// Returns if an exception was captured
+    bool hasException() const;
+
+    /// Returns the index passed to capture() for the kept exception (-1 if there is none)
+    SignedSize getIndex() const;
+
+    /// Rethrows the kept exception (does nothing if there is none)
+    void rethrow() const;
+
+private:
+    /// The kept exception
+    Internal::CapturedException * exception_;
+    /// Index of the kept exception
+    SignedSize index_;
+
+    /// not implemented
+    ParallelExceptionHandler(const ParallelExceptionHandler &);
+    ParallelExceptionHandler & operator=(const ParallelExceptionHandler &);
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_CONCEPT_PARALLELEXCEPTIONHANDLER_H
@@ -13,6 +13,7 @@ GlobalExceptionHandler.h
 LogStream.h
 LogConfigHandler.h
 Macros.h
+ParallelExceptionHandler.h
 ProgressLogger.h
 SingletonRegistry.h
 StreamHandler.h
@@ -0,0 +1,334 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_DATASTRUCTURES_FLATSET_H
+#define OPENMS_DATASTRUCTURES_FLATSET_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief A set of unique, sorted elements that is stored in a contiguous vector.
+
+    FlatSet provides the interface of std::set used in OpenMS (iteration, insert, find, erase, ...),
+    but needs no allocation per element.  This saves a lot of memory and allocation time for
+    many small sets, e.g. the feature handles of the consensus features in a ConsensusMap.
+
+    Insertion and removal are linear in the size of the set (constant when inserting in
+    sorted order).  Unlike for std::set, every insertion and removal invalidates @em all
+    iterators, pointers and references into the set.  As for std::set, elements must not be
+    modified through iterators in a way that changes their order.
+
+    @ingroup Datastructures
+  */
+  template <typename Key, typename Compare = std::less<Key> >
+  class FlatSet
+  {
+protected:
+    typedef std::vector<Key> ContainerType_;
+
+public:
+    ///@name STL compliance type definitions
+    //@{
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+    typedef typename ContainerType_::size_type size_type;
+    typedef typename ContainerType_::difference_type difference_type;
+    typedef typename ContainerType_::const_reference reference;
+    typedef typename ContainerType_::const_reference const_reference;
+    typedef typename ContainerType_::const_pointer pointer;
+    typedef typename ContainerType_::const_pointer const_pointer;
+    typedef typename ContainerType_::const_iterator iterator;
+    typedef typename ContainerType_::const_iterator const_iterator;
+    typedef typename ContainerType_::const_reverse_iterator reverse_iterator;
+    typedef typename ContainerType_::const_reverse_iterator const_reverse_iterator;
+    //@}
+
+    /// Default constructor
+    FlatSet() :
+      data_(), compare_()
+    {
+    }
+
+    /// Constructor with comparator
+    explicit FlatSet(const Compare & compare) :
+      data_(), compare_(compare)
+    {
+    }
+
+    /// Constructor from a range of (not necessarily sorted) elements
+    template <typename InputIterator>
+    FlatSet(InputIterator first, InputIterator last, const Compare & compare = Compare()) :
+      data_(first, last), compare_(compare)
+    {
+      sortUnique_();
+    }
+
+    ///@name Iterators
+    //@{
+    const_iterator begin() const
+    {
+      return data_.begin();
+    }
+
+    const_iterator end() const
+    {
+      return data_.end();
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+      return data_.rbegin();
+    }
+
+    const_reverse_iterator rend() const
+    {
+      return data_.rend();
+    }
+    //@}
+
+    ///@name Capacity
+    //@{
+    size_type size() const
+    {
+      return data_.size();
+    }
+
+    bool empty() const
+    {
+      return data_.empty();
+    }
+
+    size_type capacity() const
+    {
+      return data_.capacity();
+    }
+
+    /// Reserves memory for @p n elements
+    void reserve(size_type n)
+    {
+      data_.reserve(n);
+    }
+
+    /// Frees memory that was reserved, but is not used
+    void shrinkToFit()
+    {
+      if (data_.capacity() > data_.size())
+      {
+        ContainerType_(data_).swap(data_);
+      }
+    }
+    //@}
+
+    ///@name Modifiers
+    //@{
+    /**
+      @brief Inserts @p value, if no equivalent element is contained yet.
+
+      Returns the position of the (inserted or already contained) element and whether insertion took place.
+      All other iterators into the set are invalidated.
+    */
+    std::pair<iterator, bool> insert(const value_type & value)
+    {
+      // fast path for insertion in sorted order (e.g. when loading from a file)
+      if (data_.empty() || compare_(data_.back(), value))
+      {
+        data_.push_back(value);
+        return std::make_pair(const_iterator(data_.end() - 1), true);
+      }
+      typename ContainerType_::iterator pos = std::lower_bound(data_.begin(), data_.end(), value, compare_);
+      if (pos != data_.end() && !compare_(value, *pos))
+      {
+        return std::make_pair(const_iterator(pos), false);
+      }
+      pos = data_.insert(pos, value);
+      return std::make_pair(const_iterator(pos), true);
+    }
+
+    /// Inserts @p value; the position hint is ignored
+    iterator insert(const_iterator /* hint */, const value_type & value)
+    {
+      return insert(value).first;
+    }
+
+    /**
+      @brief Inserts a range of elements
+
+      The range may also point into this set.  All iterators into the set are invalidated.
+    */
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      // copy first: inserting into the vector would invalidate a range pointing into this set
+      ContainerType_ tmp(first, last);
+      data_.insert(data_.end(), tmp.begin(), tmp.end());
+      sortUnique_();
+    }
+
+    /// Removes the element at @p pos
+    void erase(const_iterator pos)
+    {
+      data_.erase(data_.begin() + (pos - begin()));
+    }
+
+    /// Removes the elements in the range [@p first, @p last)
+    void erase(const_iterator first, const_iterator last)
+    {
+      data_.erase(data_.begin() + (first - begin()), data_.begin() + (last - begin()));
+    }
+
+    /// Removes the element equivalent to @p key and returns the number of removed elements
+    size_type erase(const key_type & key)
+    {
+      const_iterator pos = find(key);
+      if (pos == end())
+      {
+        return 0;
+      }
+      erase(pos);
+      return 1;
+    }
+
+    void clear()
+    {
+      data_.clear();
+    }
+
+    void swap(FlatSet & rhs)
+    {
+      data_.swap(rhs.data_);
+      std::swap(compare_, rhs.compare_);
+    }
+    //@}
+
+    ///@name Lookup
+    //@{
+    const_iterator find(const key_type & key) const
+    {
+      const_iterator pos = lower_bound(key);
+      if (pos != end() && !compare_(key, *pos))
+      {
+        return pos;
+      }
+      return end();
+    }
+
+    size_type count(const key_type & key) const
+    {
+      return find(key) == end() ? 0 : 1;
+    }
+
+    const_iterator lower_bound(const key_type & key) const
+    {
+      return std::lower_bound(data_.begin(), data_.end(), key, compare_);
+    }
+
+    const_iterator upper_bound(const key_type & key) const
+    {
+      return std::upper_bound(data_.begin(), data_.end(), key, compare_);
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type & key) const
+    {
+      return std::equal_range(data_.begin(), data_.end(), key, compare_);
+    }
+
+    key_compare key_comp() const
+    {
+      return compare_;
+    }
+
+    value_compare value_comp() const
+    {
+      return compare_;
+    }
+    //@}
+
+    ///@name Comparison
+    //@{
+    bool operator==(const FlatSet & rhs) const
+    {
+      return data_ == rhs.data_;
+    }
+
+    bool operator!=(const FlatSet & rhs) const
+    {
+      return !(data_ == rhs.data_);
+    }
+
+    bool operator<(const FlatSet & rhs) const
+    {
+      return data_ < rhs.data_;
+    }
+    //@}
+
+protected:
+    /// Restores the sorted and unique state after bulk insertion (keeps the first of equivalent elements)
+    void sortUnique_()
+    {
+      std::stable_sort(data_.begin(), data_.end(), compare_);
+      data_.erase(std::unique(data_.begin(), data_.end(), EquivalentPredicate_(compare_)), data_.end());
+    }
+
+    /// Binary predicate that holds for elements which are equivalent with respect to the comparator
+    struct EquivalentPredicate_
+    {
+      explicit EquivalentPredicate_(const Compare & compare) :
+        compare(compare)
+      {
+      }
+
+      bool operator()(const Key & left, const Key & right) const
+      {
+        return !compare(left, right) && !compare(right, left);
+      }
+
+      Compare compare;
+    };
+
+    /// the sorted elements
+    ContainerType_ data_;
+    /// the element order
+    Compare compare_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_DATASTRUCTURES_FLATSET_H
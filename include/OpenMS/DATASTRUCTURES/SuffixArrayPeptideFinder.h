@@ -63,11 +63,15 @@ public:
     @param filename FASTA File name
     @param method Name of the method used (trypticCompressed, seqan, trypticSeqan)
     @param weight_mode if not monoistopic weight should be used, this parameters can be set to AVERAGE
+    @param index_file Optional base name of a persistent suffix array index.
+           If an index matching the FASTA file, method and weight mode exists it is loaded instead of
+           building the suffix array. Otherwise the suffix array is built and stored under this name for reuse.
     @throw FileNotFound is thrown if the filename is not found
     @throw ParseError is thrown if a error in parsing of the fasta file occurs
     @throw InvalidValue is thrown if an unknown method is supplied
+    @throw UnableToCreateFile is thrown if the index could not be written
     */
-    SuffixArrayPeptideFinder(const String & filename, const String & method, const WeightWrapper::WEIGHTMODE weight_mode = WeightWrapper::MONO);
+    SuffixArrayPeptideFinder(const String & filename, const String & method, const WeightWrapper::WEIGHTMODE weight_mode = WeightWrapper::MONO, const String & index_file = "");
 
     /**
     @brief copy constructor
@@ -85,6 +89,8 @@ public:
     @param candidates Output holding the candidates for input masses (one vector per mass)
                  FASTAEntry contains the FASTA header and the peptide sequence
                  The String contains the modification (if any) in the format specified by getModificationOutputMethod()
+    @note The suffix array is traversed once for all masses, so querying many masses in one call is
+          much faster than one call per mass. Candidates are converted in parallel if OpenMP is enabled.
     @see sufArray.h
     */
     void getCandidates(std::vector<std::vector<std::pair<FASTAEntry, String> > > & candidates, const std::vector<DoubleReal> & spec);
@@ -163,16 +169,30 @@ public:
     */
     String getModificationOutputMethod();
 
+    /**
+    @brief returns whether the suffix array was loaded from a stored index instead of being built
+    @return bool
+    */
+    bool isIndexLoaded() const;
+
 protected:
 
     String vToString_(std::vector<String> v);
 
+    /// returns a line identifying the database, method and weight mode an index was built for
+    String indexSignature_(const String & method, const WeightWrapper::WEIGHTMODE weight_mode) const;
+
+    /// creates the suffix array of type @p method, loading it from @p sa_file_name if not empty
+    SuffixArray * createSuffixArray_(const String & method, const String & sa_file_name, const WeightWrapper::WEIGHTMODE weight_mode) const;
+
     BigString big_string_;  ///< bigString object holding all peptides of fasta file
 
     SuffixArray * sa_;   ///< pointer to suffixarray
 
     String modification_output_method_; ///< output method for modifications
 
+    bool index_loaded_; ///< whether the suffix array was loaded from a stored index
+
   };
 
 }
@@ -18,6 +18,7 @@ DBoundingBox.h
 DIntervalBase.h
 DPosition.h
 DRange.h
+FlatSet.h
 DataValue.h
 Date.h
 DateTime.h
@@ -40,6 +40,7 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/DRange.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/PeakWidthEstimator.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/SILACPattern.h>
 
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_spline.h>
@@ -126,6 +127,39 @@ private:
      */
     void filterSeeds_();
 
+    /**
+     * @brief result of a filter at a single m/z position of the raw data
+     *
+     * The filter results are computed in parallel and recorded here, so that the blacklist can be applied afterwards in RT order.
+     */
+    struct PositionEvaluation_
+    {
+      DoubleReal mz;
+      Peak1D debug_peak;
+      bool is_silac;
+      SILACPoint point;
+      std::vector<DoubleReal> peak_positions;
+    };
+
+    /**
+     * @brief results of a filter at all m/z positions around a single seed
+     */
+    struct SeedEvaluation_
+    {
+      DoubleReal picked_mz;
+      DoubleReal peak_width;
+      SILACPattern pattern;
+      std::vector<PositionEvaluation_> positions;
+    };
+
+    /**
+     * @brief evaluates a filter at all seeds of a spectrum, ignoring the blacklist
+     * @param filter filter to use (the filter is modified, so every thread needs its own copy)
+     * @param spectrum_index index of the spectrum in the picked data seeds
+     * @param seeds the results of all seeds
+     */
+    void evaluateSpectrum_(SILACFilter & filter, Size spectrum_index, std::vector<SeedEvaluation_> & seeds) const;
+
 public:
 
     /// peak-width equation
@@ -168,6 +202,12 @@ public:
      * @brief holds the range that is blacklisted for other filters and the filter that generated the blacklist entry
      */
     std::multimap<DoubleReal, BlacklistEntry> blacklist;
+
+private:
+    /**
+     * @brief collects all blacklist entries that contain @p rt and overlap the m/z range [@p min_mz, @p max_mz]
+     */
+    void collectBlacklistCandidates_(DoubleReal rt, DoubleReal min_mz, DoubleReal max_mz, std::vector<const BlacklistEntry *> & candidates);
   };
 }
 
@@ -36,8 +36,12 @@
 #define OPENMS_FORMAT_BZIP2IFSTREAM_H
 
 #include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
 #include <bzlib.h>
 #include <istream>
+#include <cstdio>
+
+class QCryptographicHash;
 
 namespace OpenMS
 {
@@ -89,11 +93,31 @@ public:
         @brief closes current file.
     */
     void close();
+
+    /**
+        @brief Feeds the compressed bytes read from disk into @p hash while decompressing.
+
+        Every chunk read from the file is added to @p hash and counted in @p hashed_bytes.
+        Set before the first call of read(). Passing 0 disables it again.
+    */
+    void setRawDataHash(QCryptographicHash * hash, UInt64 * hashed_bytes);
+
 protected:
+    /// fills the input buffer of the bzip2 stream from the file; returns false at the end of the file
+    bool fillInput_();
+
     /// pointer to a FILE object. Necessary for opening the file
     FILE * file_;
-    /// a pointer to a BZFILE object. Necessary for decompression
-    BZFILE * bzip2file_;
+    /// bzip2 stream state. Necessary for decompression
+    bz_stream stream_;
+    /// true if stream_ was initialised and needs to be released
+    bool stream_initialized_;
+    /// input buffer for the compressed data
+    char in_buffer_[16384];
+    /// optional hash of the compressed data (not owned)
+    QCryptographicHash * raw_hash_;
+    /// number of compressed bytes added to raw_hash_
+    UInt64 * raw_hashed_bytes_;
     ///counts the last read buffer
     size_t     n_buffer_;
     ///saves the last returned error by the read function
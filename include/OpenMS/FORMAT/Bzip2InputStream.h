@@ -84,6 +84,9 @@ public:
     */
     virtual const XMLCh * getContentType() const;
 
+    /// forwards to Bzip2Ifstream::setRawDataHash(); hashes the compressed bytes as they are read
+    void setRawDataHash(QCryptographicHash * hash, UInt64 * hashed_bytes);
+
 
 private:
     ///pointer to an compression stream
@@ -102,6 +105,11 @@ private:
     return file_current_index_;
   }
 
+  inline void Bzip2InputStream::setRawDataHash(QCryptographicHash * hash, UInt64 * hashed_bytes)
+  {
+    bzip2_->setRawDataHash(hash, hashed_bytes);
+  }
+
   inline bool Bzip2InputStream::getIsOpen() const
   {
     return bzip2_->isOpen();
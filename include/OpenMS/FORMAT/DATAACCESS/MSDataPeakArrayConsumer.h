@@ -0,0 +1,123 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_DATAACCESS_MSDATAPEAKARRAYCONSUMER_H
+#define OPENMS_FORMAT_DATAACCESS_MSDATAPEAKARRAYCONSUMER_H
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/KERNEL/PeakArrayExperiment.h>
+
+namespace OpenMS
+{
+    /**
+      @brief Consumer of MS data that fills a PeakArrayExperiment
+
+      Can be passed to MzMLFile::transform to read the spectra of a file
+      directly into the compact PeakArrayExperiment, without holding the
+      whole MSExperiment in memory. Chromatograms are ignored.
+
+      Optionally, the meta data of the file and of each spectrum (settings,
+      precursors, RT, MS level ...) is collected in an MSExperiment whose
+      spectra hold no peaks. Data arrays of the spectra are not kept.
+    */
+    class OPENMS_DLLAPI MSDataPeakArrayConsumer :
+      public Interfaces::IMSDataConsumer<>
+    {
+
+    public:
+      typedef MSExperiment<> MapType;
+      typedef MapType::SpectrumType SpectrumType;
+      typedef MapType::ChromatogramType ChromatogramType;
+
+      /**
+        @brief Constructor
+
+        @param experiment The experiment to which the spectra are appended (has to stay valid while consuming)
+        @param meta_data If not null, the experimental settings and the spectra without peaks are appended to it (has to stay valid while consuming)
+      */
+      explicit MSDataPeakArrayConsumer(PeakArrayExperiment & experiment, MapType * meta_data = 0) :
+        experiment_(experiment),
+        meta_data_(meta_data)
+      {
+      }
+
+      /// Default destructor
+      ~MSDataPeakArrayConsumer() { }
+
+      void setExpectedSize(Size expectedSpectra, Size /* expectedChromatograms */)
+      {
+        // the number of peaks is not known yet
+        experiment_.reserve(experiment_.size() + expectedSpectra, experiment_.getNumberOfPeaks());
+        if (meta_data_ != 0)
+        {
+          meta_data_->reserveSpaceSpectra(meta_data_->size() + expectedSpectra);
+        }
+      }
+
+      virtual void consumeSpectrum(SpectrumType & s)
+      {
+        experiment_.addSpectrum(s);
+        if (meta_data_ != 0)
+        {
+          // copy everything but the peaks and data arrays
+          SpectrumType meta;
+          meta.SpectrumSettings::operator=(s);
+          meta.setRT(s.getRT());
+          meta.setMSLevel(s.getMSLevel());
+          meta.setName(s.getName());
+          meta_data_->addSpectrum(meta);
+        }
+      }
+
+      virtual void consumeChromatogram(ChromatogramType & /* c */)
+      {
+        // chromatograms are not stored
+      }
+
+      void setExperimentalSettings(OpenMS::ExperimentalSettings& exp)
+      {
+        if (meta_data_ != 0)
+        {
+          *meta_data_ = exp;
+        }
+      }
+
+    protected:
+      PeakArrayExperiment & experiment_;
+      MapType * meta_data_;
+    };
+
+} //end namespace OpenMS
+
+#endif // OPENMS_FORMAT_DATAACCESS_MSDATAPEAKARRAYCONSUMER_H
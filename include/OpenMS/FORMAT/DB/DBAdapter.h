@@ -39,6 +39,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/RichPeak1D.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
+#include <OpenMS/FORMAT/Base64.h>
 
 //QT includes
 #include <QtSql/QSqlQuery>
@@ -93,6 +94,22 @@ public:
     /// Non-mutable access to the options for loading/storing
     const PeakFileOptions & getOptions() const;
 
+    /**
+        @brief Sets if the peaks of a spectrum are stored as one binary entry (table DATA_PeakArray)
+
+        Storing all m/z and intensity values of a spectrum as one (optionally zlib compressed) binary entry
+        is much faster than storing one table row per peak (table DATA_Peak) and needs less space.
+        Spectra with meta data arrays or peak meta information are always stored one row per peak.
+
+        This setting only chooses the format used for storing. Loading reads the DATA_PeakArray entry of a spectrum
+        if there is one and the DATA_Peak rows otherwise, so any adapter can load data stored in either format.
+        DBs created before the DATA_PeakArray table was added always use the DATA_Peak table.
+    */
+    void setBinaryPeakStorage(bool binary, bool compress = true);
+
+    /// Returns if the peaks of a spectrum are stored as one binary entry
+    bool getBinaryPeakStorage() const;
+
     /**
         @brief Returns true if the DB is up-to-date (Checks the version in ADMIN_Version table).
 
@@ -110,6 +127,33 @@ private:
     /// Not implemented
     DBAdapter();
 
+    /// Stores a MSExperiment (the actual implementation of storeExperiment(), which runs it in a transaction)
+    template <class ExperimentType>
+    void storeExperiment_(ExperimentType & exp);
+
+    /// Reads a MSSpectrum. @p peak_array_select is the query from preparePeakArraySelect_(), or 0 if DATA_PeakArray is not used.
+    template <class SpectrumType>
+    void loadSpectrum_(UID id, SpectrumType & spec, QSqlQuery * peak_array_select);
+
+    /// Returns if the DB has the DATA_PeakArray table (DBs created before binary peak storage do not)
+    bool hasPeakArrayTable_();
+
+    /// Prepares the query that selects the DATA_PeakArray entry of a spectrum (for loadPeakArrays_())
+    QSqlQuery preparePeakArraySelect_();
+
+    /// Stores the peaks of a spectrum as binary arrays in the DATA_PeakArray table using the prepared INSERT query @p insert
+    template <class SpectrumType>
+    void storePeakArrays_(QSqlQuery & insert, UID spectrum_id, const SpectrumType & spec);
+
+    /// Loads the peaks of a spectrum from the DATA_PeakArray table using the query @p select from preparePeakArraySelect_(). Returns false if there is no entry for the spectrum.
+    template <class SpectrumType>
+    bool loadPeakArrays_(QSqlQuery & select, UID spectrum_id, SpectrumType & spec);
+
+    /// Returns if the peak has meta information that cannot be stored in the DATA_PeakArray table
+    bool hasMetaInfo_(const Peak1D & peak) const;
+    /// Overloaded method for RichPeak1D
+    bool hasMetaInfo_(const RichPeak1D & peak) const;
+
     /**
         @brief Stores, updates or deletes MetaInfo data
 
@@ -165,6 +209,12 @@ private:
     void loadSample_(UID id, Sample & sample);
 
     PeakFileOptions options_;
+
+    /// Store the peaks of a spectrum as one binary entry
+    bool binary_peaks_;
+
+    /// Compress the binary peak data
+    bool compress_peaks_;
   };
 
 
@@ -172,6 +222,29 @@ private:
 
   template <class ExperimentType>
   void DBAdapter::storeExperiment(ExperimentType & exp)
+  {
+    // one transaction for the whole experiment is much faster than committing each statement
+    bool transaction = db_con_.beginTransaction();
+    try
+    {
+      storeExperiment_(exp);
+    }
+    catch (...)
+    {
+      if (transaction)
+      {
+        db_con_.rollbackTransaction();
+      }
+      throw;
+    }
+    if (transaction)
+    {
+      db_con_.commitTransaction();
+    }
+  }
+
+  template <class ExperimentType>
+  void DBAdapter::storeExperiment_(ExperimentType & exp)
   {
     std::stringstream query;     // query to build
     String end;                  // end of the query that is added afer all fields
@@ -614,6 +687,20 @@ private:
       storeMetaInfo_("META_MassAnalyzer", db_con_.getAutoId(), *analyzer_it);
     }
 
+    // the DATA_PeakArray queries are prepared once for all spectra. Old entries are always deleted (they would
+    // take precedence when loading), new ones are only written with binary peak storage.
+    bool peak_array_table = hasPeakArrayTable_();
+    bool peak_arrays = binary_peaks_ && peak_array_table;
+    QSqlQuery peak_array_delete, peak_array_insert;
+    if (peak_array_table)
+    {
+      peak_array_delete = db_con_.prepareQuery("DELETE FROM DATA_PeakArray WHERE fid_Spectrum=?");
+    }
+    if (peak_arrays)
+    {
+      peak_array_insert = db_con_.prepareQuery("INSERT INTO DATA_PeakArray (fid_Spectrum,Size,Compressed,mz,Intensity) VALUES (?,?,?,?,?)");
+    }
+
     //----------------------------------------------------------------------------------------
     //------------------------------------- store SPECTRUM -----------------------------------
     //----------------------------------------------------------------------------------------
@@ -796,7 +883,23 @@ private:
       query.str("");
       deleteMetaInfo_("DATA_Peak", "fid_Spectrum=" + String(exp_it->getPersistenceId()));
       result = db_con_.executeQuery("DELETE FROM DATA_Peak WHERE fid_Spectrum=" + String(exp_it->getPersistenceId()));
-      if (exp_it->size() != 0)
+      if (peak_array_table)
+      {
+        peak_array_delete.bindValue(0, QVariant((qulonglong)exp_it->getPersistenceId()));
+        db_con_.executePreparedQuery(peak_array_delete);
+      }
+
+      bool binary_peaks = peak_arrays && exp_it->getFloatDataArrays().empty();
+      for (typename ExperimentType::SpectrumType::ConstIterator spec_it = exp_it->begin(); binary_peaks && spec_it != exp_it->end(); ++spec_it)
+      {
+        binary_peaks = !hasMetaInfo_(*spec_it);
+      }
+
+      if (binary_peaks)
+      {
+        storePeakArrays_(peak_array_insert, exp_it->getPersistenceId(), *exp_it);
+      }
+      else if (exp_it->size() != 0)
       {
         query << "INSERT INTO DATA_Peak (fid_Spectrum,Intensity,mz) VALUES ";
         tmp = "(" + String(exp_it->getPersistenceId()) + ",'";
@@ -814,11 +917,14 @@ private:
       }
       // We know that all inserted peaks have IDs beginning from last_insert_id() (= ID of first inserted entry
       // of last insert operation), so we can insert Meta Information without actually fetching the ID
-      UID insert_id = db_con_.getAutoId();
-      for (typename ExperimentType::SpectrumType::Iterator spec_it = exp_it->begin(); spec_it != exp_it->end(); ++spec_it)
+      if (!binary_peaks)
       {
-        storeMetaInfo_("DATA_Peak", insert_id, *spec_it);
-        insert_id++;
+        UID insert_id = db_con_.getAutoId();
+        for (typename ExperimentType::SpectrumType::Iterator spec_it = exp_it->begin(); spec_it != exp_it->end(); ++spec_it)
+        {
+          storeMetaInfo_("DATA_Peak", insert_id, *spec_it);
+          insert_id++;
+        }
       }
 
       //----------------------------------------------------------------------------------------
@@ -1407,10 +1513,19 @@ private:
 
     result = db_con_.executeQuery(query.str());
     exp.resize(result.size());
+
+    // the DATA_PeakArray query is prepared once for all spectra (independent of the storage format setting)
+    bool peak_arrays = hasPeakArrayTable_();
+    QSqlQuery peak_array_select;
+    if (peak_arrays)
+    {
+      peak_array_select = preparePeakArraySelect_();
+    }
+
     UInt i = 0;
     while (result.next())
     {
-      loadSpectrum(result.value(0).toInt(), exp[i]);
+      loadSpectrum_(result.value(0).toInt(), exp[i], peak_arrays ? &peak_array_select : 0);
       ++i;
     }
 
@@ -1418,6 +1533,20 @@ private:
 
   template <class SpectrumType>
   void DBAdapter::loadSpectrum(UID id, SpectrumType & spec)
+  {
+    if (hasPeakArrayTable_())
+    {
+      QSqlQuery peak_array_select = preparePeakArraySelect_();
+      loadSpectrum_(id, spec, &peak_array_select);
+    }
+    else
+    {
+      loadSpectrum_(id, spec, 0);
+    }
+  }
+
+  template <class SpectrumType>
+  void DBAdapter::loadSpectrum_(UID id, SpectrumType & spec, QSqlQuery * peak_array_select)
   {
 
     //----------------------------------------------------------------------------------------
@@ -1676,6 +1805,12 @@ private:
     //--------------------------- load PEAKS/METADATAARRAYS ----------------------------------
     //----------------------------------------------------------------------------------------
 
+    if (peak_array_select != 0 && loadPeakArrays_(*peak_array_select, id, spec))
+    {
+      spec.setPersistenceId(id);
+      return;
+    }
+
     query.str("");
     query << "SELECT mz,Intensity,fid_MetaInfo,id FROM DATA_Peak WHERE fid_Spectrum='" << id << "' ";
     if (options_.hasMZRange())
@@ -1714,6 +1849,72 @@ private:
     spec.setPersistenceId(id);
   }
 
+  template <class SpectrumType>
+  void DBAdapter::storePeakArrays_(QSqlQuery & insert, UID spectrum_id, const SpectrumType & spec)
+  {
+    std::vector<DoubleReal> mz;
+    std::vector<Real> intensity;
+    mz.reserve(spec.size());
+    intensity.reserve(spec.size());
+    for (typename SpectrumType::ConstIterator it = spec.begin(); it != spec.end(); ++it)
+    {
+      mz.push_back(it->getMZ());
+      intensity.push_back(it->getIntensity());
+    }
+
+    Base64 base64;
+    String mz_string, intensity_string;
+    base64.encode(mz, Base64::BYTEORDER_LITTLEENDIAN, mz_string, compress_peaks_);
+    base64.encode(intensity, Base64::BYTEORDER_LITTLEENDIAN, intensity_string, compress_peaks_);
+
+    insert.bindValue(0, QVariant((qulonglong)spectrum_id));
+    insert.bindValue(1, QVariant((uint)spec.size()));
+    insert.bindValue(2, QVariant(compress_peaks_ ? 1 : 0));
+    insert.bindValue(3, QByteArray(mz_string.c_str(), (int)mz_string.size()));
+    insert.bindValue(4, QByteArray(intensity_string.c_str(), (int)intensity_string.size()));
+    db_con_.executePreparedQuery(insert);
+  }
+
+  template <class SpectrumType>
+  bool DBAdapter::loadPeakArrays_(QSqlQuery & select, UID spectrum_id, SpectrumType & spec)
+  {
+    select.bindValue(0, QVariant((qulonglong)spectrum_id));
+    db_con_.executePreparedQuery(select);
+    if (!select.next())
+    {
+      return false;
+    }
+
+    bool compressed = select.value(0).toInt() != 0;
+    QByteArray mz_bytes = select.value(1).toByteArray();
+    QByteArray intensity_bytes = select.value(2).toByteArray();
+
+    Base64 base64;
+    std::vector<DoubleReal> mz;
+    std::vector<Real> intensity;
+    base64.decode(String(mz_bytes.constData(), mz_bytes.size()), Base64::BYTEORDER_LITTLEENDIAN, mz, compressed);
+    base64.decode(String(intensity_bytes.constData(), intensity_bytes.size()), Base64::BYTEORDER_LITTLEENDIAN, intensity, compressed);
+
+    spec.reserve(mz.size());
+    typename SpectrumType::PeakType p;
+    for (Size i = 0; i < mz.size() && i < intensity.size(); ++i)
+    {
+      // same (exclusive) range semantics as the SQL query used for DATA_Peak
+      if (options_.hasMZRange() && (mz[i] <= options_.getMZRange().minPosition()[0] || mz[i] >= options_.getMZRange().maxPosition()[0]))
+      {
+        continue;
+      }
+      if (options_.hasIntensityRange() && (intensity[i] <= options_.getIntensityRange().minPosition()[0] || intensity[i] >= options_.getIntensityRange().maxPosition()[0]))
+      {
+        continue;
+      }
+      p.setMZ(mz[i]);
+      p.setIntensity(intensity[i]);
+      spec.push_back(p);
+    }
+    return true;
+  }
+
 }
 
 #endif
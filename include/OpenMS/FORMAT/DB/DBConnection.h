@@ -137,6 +137,43 @@ public:
     */
     QSqlQuery executeQuery(const String & query, bool first = false);
 
+    /**
+      @brief Prepares a query with placeholders ('?') for repeated execution
+
+      Bind the values with QSqlQuery::bindValue() and execute the query with executePreparedQuery().
+      The query can be executed repeatedly with new bound values, which avoids building and parsing
+      the SQL text for every row. It also allows binary values (e.g. BLOBs).
+
+      @exception InvalidQuery is thrown if an invalid SQL query was given
+      @exception NotConnected if there is no database connection
+    */
+    QSqlQuery prepareQuery(const String & query);
+
+    /**
+      @brief Executes a query that was created with prepareQuery() with the currently bound values
+
+      @exception InvalidQuery is thrown if the query failed
+    */
+    void executePreparedQuery(QSqlQuery & query);
+
+    /**
+      @brief Starts a transaction. Returns false if the driver does not support transactions.
+
+      @exception NotConnected if there is no database connection
+    */
+    bool beginTransaction();
+
+    /**
+      @brief Commits the current transaction
+
+      @exception InvalidQuery is thrown if the commit failed
+      @exception NotConnected if there is no database connection
+    */
+    void commitTransaction();
+
+    /// Rolls back the current transaction (errors are ignored)
+    void rollbackTransaction();
+
     /**
         @brief Returns a single field of a table as an integer
 
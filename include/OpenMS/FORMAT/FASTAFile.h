@@ -38,6 +38,7 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <fstream>
 #include <vector>
 
 namespace OpenMS
@@ -87,7 +88,7 @@ public:
 
     };
 
-    /// Copy constructor
+    /// Default constructor
     FASTAFile();
 
     /// Destructor
@@ -101,6 +102,27 @@ public:
     */
     void load(const String& filename, std::vector<FASTAEntry>& data);
 
+    /**
+      @brief prepares reading a FASTA file entry by entry using readNext()
+
+      Use this for databases which are too large to be held in memory as a whole.
+
+      @exception Exception::FileNotFound is thrown if the file does not exists.
+      @exception Exception::FileNotReadable is thrown if the file is not readable.
+    */
+    void readStart(const String& filename);
+
+    /**
+      @brief reads the next entry of the file opened by readStart()
+
+      @return false if there are no more entries (@p protein is not changed in this case)
+      @exception Exception::ParseError is thrown if the entry could not be parsed.
+    */
+    bool readNext(FASTAEntry& protein);
+
+    /// returns true if the file opened by readStart() has no more entries
+    bool atEnd();
+
     /**
       @brief stores the data given by 'data' at the file 'filename'
 
@@ -108,6 +130,24 @@ public:
     */
     void store(const String& filename, const std::vector<FASTAEntry>& data) const;
 
+protected:
+
+    /// closes the file opened by readStart()
+    void readEnd_();
+
+    std::fstream infile_; ///< file opened by readStart()
+    void* reader_; ///< seqan record reader on infile_ (not exposed to keep seqan out of this header)
+    String filename_; ///< name of the file opened by readStart()
+    String last_identifier_; ///< identifier of the last entry returned by readNext() (for error messages)
+
+private:
+
+    /// not implemented (the file stream cannot be copied)
+    FASTAFile(const FASTAFile&);
+
+    /// not implemented (the file stream cannot be copied)
+    FASTAFile& operator=(const FASTAFile&);
+
   };
 
 } // namespace OpenMS
@@ -103,6 +103,19 @@ public:
     /// Non-mutable access to the options for loading/storing
     const PeakFileOptions& getOptions() const;
 
+    /**
+      @brief Sets the directory of the persistent file hash cache (empty, the default, disables the cache)
+
+      If set, the hash computed by loadExperiment() is stored in this directory, keyed by the absolute path,
+      size and modification time of the file. Loading the unchanged file again (also in another process)
+      reuses the stored hash. A typical location is File::getUserDirectory() + ".OpenMS/file_hashes".
+      The directory is created if it does not exist.
+    */
+    void setHashCacheDirectory(const String& dir);
+
+    /// Returns the directory of the persistent file hash cache (empty if disabled)
+    const String& getHashCacheDirectory() const;
+
     /**
       @brief Loads a file into an MSExperiment
 
@@ -110,7 +123,9 @@ public:
       @param exp The experiment to load the data into.
       @param force_type Forces to load the file with that file type. If no type is forced, it is determined from the extention ( or from the content if that fails).
       @param log Progress logging mode
-      @param compute_hash Computes a hash value for the loaded file and stores it in the SourceFile
+      @param compute_hash Computes a hash value for the loaded file and stores it in the SourceFile.
+             For mzML, mzXML and mzData files (also gzip or bzip2 compressed) the hash is computed while the file is parsed.
+             If a hash cache directory is set (see setHashCacheDirectory()), a cached hash of the unchanged file is used instead.
 
       @return true if the file could be loaded, false otherwise
 
@@ -138,6 +153,11 @@ public:
         }
       }
 
+      //hash of the unchanged file from the cache, otherwise computed while parsing (if supported by the file type)
+      String hash = compute_hash ? lookupCachedFileHash_(filename) : String();
+      const bool hash_cached = !hash.empty();
+      const bool hash_while_parsing = compute_hash && !hash_cached;
+
       //load right file
       switch (type)
       {
@@ -162,7 +182,12 @@ public:
         MzXMLFile f;
         f.getOptions() = options_;
         f.setLogType(log);
+        f.setComputeFileHash(hash_while_parsing);
         f.load(filename, exp);
+        if (hash_while_parsing)
+        {
+          hash = f.getFileHash();
+        }
       }
 
       break;
@@ -172,7 +197,12 @@ public:
         MzDataFile f;
         f.getOptions() = options_;
         f.setLogType(log);
+        f.setComputeFileHash(hash_while_parsing);
         f.load(filename, exp);
+        if (hash_while_parsing)
+        {
+          hash = f.getFileHash();
+        }
       }
       break;
 
@@ -181,7 +211,12 @@ public:
         MzMLFile f;
         f.getOptions() = options_;
         f.setLogType(log);
+        f.setComputeFileHash(hash_while_parsing);
         f.load(filename, exp);
+        if (hash_while_parsing)
+        {
+          hash = f.getFileHash();
+        }
         ChromatogramTools().convertSpectraToChromatograms<MSExperiment<PeakType> >(exp, true);
       }
       break;
@@ -227,7 +262,15 @@ public:
 
       if (compute_hash)
       {
-        src_file.setChecksum(computeFileHash_(filename), SourceFile::SHA1);
+        if (hash.empty())
+        {
+          hash = computeFileHash_(filename);
+        }
+        if (!hash_cached)
+        {
+          storeCachedFileHash_(filename, hash);
+        }
+        src_file.setChecksum(hash, SourceFile::SHA1);
       }
 
       exp.getSourceFiles().clear();
@@ -370,12 +413,25 @@ public:
 private:
     PeakFileOptions options_;
 
+    /// Directory of the persistent file hash cache (empty if disabled)
+    String hash_cache_dir_;
+
     /**
       @brief Computes a SHA-1 hash value for the content of the given file.
 
       @return The SHA-1 hash of the given file.
     */
     String computeFileHash_(const String& filename) const;
+
+    /**
+      @brief Looks up the hash of the given file in the hash cache.
+
+      @return The cached SHA-1 hash, or an empty string if the cache is disabled, has no entry or the file changed.
+    */
+    String lookupCachedFileHash_(const String& filename) const;
+
+    /// Stores the hash of the given file in the hash cache (does nothing if the cache is disabled)
+    void storeCachedFileHash_(const String& filename, const String& hash) const;
   };
 
 } //namespace
@@ -98,6 +98,8 @@ namespace OpenMS
       ANALYSISXML,        ///< analysisXML format
       XSD,                ///< XSD schema format
       PSQ,                ///< NCBI binary blast db
+      IDBIN,              ///< %OpenMS binary identification format (.idbin)
+      TRBIN,              ///< %OpenMS binary transition library for OpenSWATH (.trbin)
       SIZE_OF_TYPE        ///< No file type. Simply stores the number of types
     };
 
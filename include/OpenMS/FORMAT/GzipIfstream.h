@@ -36,7 +36,11 @@
 #define OPENMS_FORMAT_GZIPIFSTREAM_H
 
 #include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
 #include <zlib.h>
+#include <cstdio>
+
+class QCryptographicHash;
 
 namespace OpenMS
 {
@@ -88,6 +92,15 @@ public:
     */
     void close();
 
+    /**
+        @brief Feeds the compressed bytes read from disk into @p hash while decompressing.
+
+        Every chunk read from the file is added to @p hash and counted in @p hashed_bytes,
+        so a checksum of the file on disk is available without reading it a second time.
+        Set before the first call of read(). Passing 0 disables it again.
+    */
+    void setRawDataHash(QCryptographicHash * hash, UInt64 * hashed_bytes);
+
     /*
         @brief updates crc32 check sum whether the buffer is corrupted
         @note if this function is used it has to be called after every call of function read
@@ -108,8 +121,19 @@ public:
 
 protected:
 
-    ///a gzFile object(void*) . Necessary for decompression
-    gzFile gzfile_;
+    /// fills the input buffer of the zlib stream from the file; returns false at the end of the file
+    bool fillInput_();
+
+    ///the compressed file
+    FILE * file_;
+    ///zlib stream state. Necessary for decompression
+    z_stream stream_;
+    ///input buffer for the compressed data
+    unsigned char in_buffer_[16384];
+    ///optional hash of the compressed data (not owned)
+    QCryptographicHash * raw_hash_;
+    ///number of compressed bytes added to raw_hash_
+    UInt64 * raw_hashed_bytes_;
     ///counts the last read bufffer
     int     n_buffer_;
     ///saves the last returned error by the read function
@@ -129,7 +153,7 @@ protected:
 
   inline bool GzipIfstream::isOpen() const
   {
-    return gzfile_ != NULL;
+    return file_ != NULL;
   }
 
   inline bool GzipIfstream::streamEnd() const
@@ -84,6 +84,9 @@ public:
     */
     virtual const XMLCh * getContentType() const;
 
+    /// forwards to GzipIfstream::setRawDataHash(); hashes the compressed bytes as they are read
+    void setRawDataHash(QCryptographicHash * hash, UInt64 * hashed_bytes);
+
 
 private:
     ///pointer to an compression stream
@@ -102,6 +105,11 @@ private:
     return file_current_index_;
   }
 
+  inline void GzipInputStream::setRawDataHash(QCryptographicHash * hash, UInt64 * hashed_bytes)
+  {
+    gzip_->setRawDataHash(hash, hashed_bytes);
+  }
+
   inline bool GzipInputStream::getIsOpen() const
   {
     return gzip_->isOpen();
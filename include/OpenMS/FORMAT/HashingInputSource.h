@@ -0,0 +1,94 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_HASHINGINPUTSOURCE_H
+#define OPENMS_FORMAT_HASHINGINPUTSOURCE_H
+
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <xercesc/framework/LocalFileInputSource.hpp>
+
+class QCryptographicHash;
+
+namespace OpenMS
+{
+  /**
+      @brief A xercesc::LocalFileInputSource that computes the SHA-1 hash of the file while the parser reads it
+
+      All bytes read from disk are added to the hash, so the file is read only once.
+      gzip and bzip2 compressed files are decompressed on the fly (like CompressedInputSource);
+      their hash is taken over the compressed bytes on disk, not the decompressed XML.
+      If parsing is aborted early, getHash() reads the rest of the file to complete the hash.
+  */
+  class OPENMS_DLLAPI HashingInputSource :
+    public xercesc::LocalFileInputSource
+  {
+public:
+    ///Constructor
+    HashingInputSource(const String & file_path, xercesc::MemoryManager * const manager = xercesc::XMLPlatformUtils::fgMemoryManager);
+    ///Destructor
+    virtual ~HashingInputSource();
+
+    /**
+       @brief Returns a (decompressing) stream on the file that adds all bytes read from disk to the hash
+         @note InputSource interface implementation
+       */
+    virtual xercesc::BinInputStream * makeStream() const;
+
+    /**
+       @brief Returns the SHA-1 hash (hex encoded) of the whole file
+
+       Bytes not read by the parser are read from the file here.
+
+       @exception Exception::FileNotFound is thrown if the remaining part of the file cannot be read
+    */
+    String getHash() const;
+
+private:
+    /// Path of the file
+    String file_path_;
+    /// Hash of the bytes read so far
+    QCryptographicHash * crypto_;
+    /// Number of bytes added to the hash
+    mutable UInt64 hashed_bytes_;
+
+    /// private CTor - not implemented
+    HashingInputSource();
+    HashingInputSource(const HashingInputSource & source);
+    HashingInputSource & operator=(const HashingInputSource & source);
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_FORMAT_HASHINGINPUTSOURCE_H
@@ -0,0 +1,224 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_IDBINARYFILE_H
+#define OPENMS_FORMAT_IDBINARYFILE_H
+
+#include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <QtCore/QFile>
+
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cstring>
+
+namespace OpenMS
+{
+  /**
+    @brief Compact binary container for identification results with random access to single peptide identifications
+
+    This format stores the same information as an idXML file, but avoids XML parsing and
+    duplicated strings. Its layout is:
+
+    - header: magic number, schema version, number of protein and peptide identifications,
+      offsets of the string table and of the peptide index
+    - all ProteinIdentification instances
+    - all PeptideIdentification instances, one record each
+    - string table: every distinct string (identifiers, sequences, accessions, meta value keys and string values) is stored once
+      and referenced by its index everywhere else
+    - peptide index: the file offset of every peptide identification record
+
+    All numbers are stored in the byte order of the machine that wrote the file.
+
+    Besides loading the whole file via load(), the file can be opened with open(). It is then memory mapped and single
+    peptide identifications are decoded on request (see getPeptideIdentification()), so that tools which only need a
+    subset of the identifications neither parse nor hold the remainder in memory.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI IdBinaryFile :
+    public ProgressLogger
+  {
+public:
+
+    /// Magic number at the start of every file
+    static const UInt MAGIC_NUMBER;
+
+    /// Version of the file layout written by this class
+    static const UInt SCHEMA_VERSION;
+
+    /// Default constructor
+    IdBinaryFile();
+
+    /// Destructor (closes an opened file)
+    virtual ~IdBinaryFile();
+
+    /**
+      @brief Stores the identifications in a binary file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String & filename, const std::vector<ProteinIdentification> & protein_ids, const std::vector<PeptideIdentification> & peptide_ids) const;
+
+    /**
+      @brief Loads all identifications of a binary file
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is no valid binary identification file
+    */
+    void load(const String & filename, std::vector<ProteinIdentification> & protein_ids, std::vector<PeptideIdentification> & peptide_ids);
+
+    /** @name Lazy access */
+    //@{
+    /**
+      @brief Maps the file into memory and reads the header, without decoding any identification
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is no valid binary identification file
+    */
+    void open(const String & filename);
+
+    /// Unmaps and closes the file opened with open()
+    void close();
+
+    /// Returns if a file is currently opened
+    bool isOpen() const;
+
+    /// Returns the number of peptide identifications of the opened file
+    Size getNumberOfPeptideIdentifications() const;
+
+    /// Decodes all protein identifications of the opened file
+    void getProteinIdentifications(std::vector<ProteinIdentification> & protein_ids) const;
+
+    /**
+      @brief Decodes the peptide identification with index @p index of the opened file
+
+      @exception Exception::IndexOverflow is thrown if @p index is out of bounds
+    */
+    void getPeptideIdentification(Size index, PeptideIdentification & peptide_id) const;
+    //@}
+
+protected:
+
+    /// Collects strings for the string table while writing
+    struct StringTable_
+    {
+      std::map<String, UInt> index;
+      std::vector<const String *> strings;
+
+      UInt insert(const String & s);
+    };
+
+    /// Reading position in the mapped file
+    struct Reader_
+    {
+      const uchar * pos;
+      const uchar * end;
+
+      template <typename T>
+      T read()
+      {
+        if (pos + sizeof(T) > end)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, __PRETTY_FUNCTION__, "", "Unexpected end of binary identification file");
+        }
+        T value;
+        memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+      }
+    };
+
+    /// Writes a plain value
+    template <typename T>
+    static void write_(std::ofstream & os, const T & value)
+    {
+      os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /// Writes a reference to @p s into the string table
+    static void writeString_(std::ofstream & os, StringTable_ & strings, const String & s);
+    /// Writes the meta values of @p meta
+    static void writeMetaInfo_(std::ofstream & os, StringTable_ & strings, const MetaInfoInterface & meta);
+    /// Writes a protein group
+    static void writeProteinGroups_(std::ofstream & os, StringTable_ & strings, const std::vector<ProteinIdentification::ProteinGroup> & groups);
+    /// Writes a protein identification (including its hits)
+    static void writeProteinIdentification_(std::ofstream & os, StringTable_ & strings, const ProteinIdentification & protein_id);
+    /// Writes a peptide identification (including its hits)
+    static void writePeptideIdentification_(std::ofstream & os, StringTable_ & strings, const PeptideIdentification & peptide_id);
+
+    /// Reads a string table reference
+    String readString_(Reader_ & in) const;
+    /// Reads meta values into @p meta
+    void readMetaInfo_(Reader_ & in, MetaInfoInterface & meta) const;
+    /// Reads protein groups
+    void readProteinGroups_(Reader_ & in, std::vector<ProteinIdentification::ProteinGroup> & groups) const;
+    /// Reads a protein identification
+    void readProteinIdentification_(Reader_ & in, ProteinIdentification & protein_id) const;
+    /// Reads a peptide identification
+    void readPeptideIdentification_(Reader_ & in, PeptideIdentification & peptide_id) const;
+
+    /// Returns a reader positioned at @p offset of the mapped file
+    Reader_ readerAt_(UInt64 offset) const;
+
+    /// The opened file
+    QFile file_;
+    /// Start of the memory mapped file
+    const uchar * data_;
+    /// Size of the memory mapped file
+    UInt64 size_;
+    /// Number of protein identifications
+    UInt64 protein_id_count_;
+    /// Number of peptide identifications
+    UInt64 peptide_id_count_;
+    /// Offset of the peptide index
+    UInt64 peptide_index_offset_;
+    /// Offsets of the strings in the string table (strings are only decoded when referenced)
+    std::vector<UInt64> string_offsets_;
+
+private:
+
+    /// Not implemented
+    IdBinaryFile(const IdBinaryFile &);
+    /// Not implemented
+    IdBinaryFile & operator=(const IdBinaryFile &);
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_FORMAT_IDBINARYFILE_H
@@ -73,6 +73,17 @@ public:
       ///return the version of the schema
       const String & getVersion() const;
 
+      /**
+        @brief Enables computing the SHA-1 hash of the file while it is parsed
+
+        This avoids reading the file a second time only to compute its hash.
+        For gzip and bzip2 compressed files, the hash is computed over the compressed bytes on disk.
+      */
+      void setComputeFileHash(bool compute);
+
+      ///return the SHA-1 hash of the last parsed file (empty if it was not computed, see setComputeFileHash())
+      const String & getFileHash() const;
+
 protected:
       /**
         @brief Parses the XML file given by @p filename using the handler given by @p handler.
@@ -98,6 +109,12 @@ protected:
       /// Encoding string that replaces the encoding (system dependend or specified in the XML). Disabled if empty. Used as a workaround for XTandem output xml.
       String enforced_encoding_;
 
+      /// Flag that indicates whether the file hash is computed during parsing
+      bool compute_file_hash_;
+
+      /// SHA-1 hash of the last parsed file
+      String file_hash_;
+
       void enforceEncoding_(const String& encoding);
     };
 
@@ -40,6 +40,8 @@ FeatureXMLFile.h
 FileHandler.h
 GzipIfstream.h
 GzipInputStream.h
+HashingInputSource.h
+IdBinaryFile.h
 IdXMLFile.h
 IndexedMzMLFile.h
 InspectInfile.h
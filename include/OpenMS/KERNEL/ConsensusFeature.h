@@ -36,6 +36,7 @@
 #define OPENMS_KERNEL_CONSENSUSFEATURE_H
 
 #include <OpenMS/DATASTRUCTURES/DRange.h>
+#include <OpenMS/DATASTRUCTURES/FlatSet.h>
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/KERNEL/FeatureHandle.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
@@ -52,6 +53,10 @@ namespace OpenMS
     FeatureHandle instances.  Each ConsensusFeature "contains" zero or more
     FeatureHandles.
 
+    The feature handles are stored in a FlatSet, i.e. a sorted vector, instead of a
+    std::set. This avoids one allocation per handle, which matters for large maps with
+    many input maps.  Note that inserting handles invalidates iterators.
+
     @see ConsensusMap
 
     @ingroup Kernel
@@ -62,7 +67,7 @@ namespace OpenMS
 public:
     ///Type definitions
     //@{
-    typedef std::set<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
+    typedef FlatSet<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
     typedef HandleSetType::const_iterator const_iterator;
     typedef HandleSetType::iterator iterator;
     typedef HandleSetType::const_reverse_iterator const_reverse_iterator;
@@ -0,0 +1,206 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_KERNEL_PEAKARRAYEXPERIMENT_H
+#define OPENMS_KERNEL_PEAKARRAYEXPERIMENT_H
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief A compact, array based representation of the peaks of an MS experiment.
+
+    In contrast to MSExperiment, which stores each spectrum as a vector of peaks (interleaved
+    m/z and intensity) together with the full SpectrumSettings, all peaks of all spectra are
+    stored in two contiguous arrays (m/z and intensity), one after the other. The peaks of
+    spectrum @em i are found in the range [getSpectrumBegin(i), getSpectrumEnd(i)) of these arrays.
+    Per spectrum, only retention time, MS level and native ID are kept.
+
+    This layout needs considerably less memory than MSExperiment and allows fast scans over
+    the m/z or intensity values only. It is meant for large raw data sets that are read once and
+    then searched many times (e.g. for extracting ion chromatograms).  It can be filled directly
+    while reading mzML (see MSDataPeakArrayConsumer) or from an MSExperiment.
+
+    @note The m/z values of each spectrum are expected to be sorted, as in a sorted MSSpectrum.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI PeakArrayExperiment
+  {
+public:
+    /// Peak type of the spectra that can be converted from and to
+    typedef Peak1D PeakType;
+    /// Spectrum type that can be converted from and to
+    typedef MSSpectrum<PeakType> SpectrumType;
+
+    /** @name Constructors and Destructor
+    */
+    //@{
+    /// Default constructor
+    PeakArrayExperiment();
+
+    /// Constructor from an MSExperiment (chromatograms and meta data except RT, MS level and native ID are discarded)
+    explicit PeakArrayExperiment(const MSExperiment<PeakType> & exp);
+
+    /// Copy constructor
+    PeakArrayExperiment(const PeakArrayExperiment & rhs);
+
+    /// Assignment operator
+    PeakArrayExperiment & operator=(const PeakArrayExperiment & rhs);
+
+    /// Destructor
+    virtual ~PeakArrayExperiment();
+    //@}
+
+    /// Equality operator
+    bool operator==(const PeakArrayExperiment & rhs) const;
+
+    /// Equality operator
+    bool operator!=(const PeakArrayExperiment & rhs) const;
+
+    /** @name Filling
+    */
+    //@{
+    /// Reserves memory for @p spectra spectra with @p peaks peaks in total
+    void reserve(Size spectra, Size peaks);
+
+    /// Appends a spectrum
+    void addSpectrum(const SpectrumType & spectrum);
+
+    /**
+      @brief Appends a spectrum given by m/z and intensity arrays of length @p size
+
+      @exception Exception::NullPointer is thrown if @p size is not 0 but @p mz or @p intensity are null pointers
+    */
+    void addSpectrum(DoubleReal rt, UInt ms_level, const String & native_id, const DoubleReal * mz, const Real * intensity, Size size);
+
+    /// Removes all spectra
+    void clear();
+    //@}
+
+    /** @name Conversion
+    */
+    //@{
+    /// Copies the spectrum with index @p index to @p spectrum (existing peaks of @p spectrum are removed)
+    void getSpectrum(Size index, SpectrumType & spectrum) const;
+
+    /// Converts all spectra to an MSExperiment (existing spectra of @p exp are removed)
+    void getExperiment(MSExperiment<PeakType> & exp) const;
+    //@}
+
+    /** @name Accessors
+    */
+    //@{
+    /// Returns the number of spectra
+    Size size() const;
+
+    /// Returns if there are no spectra
+    bool empty() const;
+
+    /// Returns the total number of peaks
+    Size getNumberOfPeaks() const;
+
+    /// Returns the retention time of spectrum @p index
+    DoubleReal getRT(Size index) const;
+
+    /// Returns the MS level of spectrum @p index
+    UInt getMSLevel(Size index) const;
+
+    /// Returns the native ID of spectrum @p index
+    const String & getNativeID(Size index) const;
+
+    /// Returns the index of the first peak of spectrum @p index in the peak arrays
+    Size getSpectrumBegin(Size index) const;
+
+    /// Returns the index after the last peak of spectrum @p index in the peak arrays
+    Size getSpectrumEnd(Size index) const;
+
+    /// Returns the m/z values of all spectra
+    const std::vector<DoubleReal> & getMZArray() const;
+
+    /// Returns the intensity values of all spectra
+    const std::vector<Real> & getIntensityArray() const;
+
+    /// Returns mutable intensity values of all spectra (e.g. for normalization)
+    std::vector<Real> & getIntensityArray();
+    //@}
+
+    /** @name Searching
+    */
+    //@{
+    /// Returns the index of the first spectrum with a retention time not smaller than @p rt
+    Size RTBegin(DoubleReal rt) const;
+
+    /// Returns the peak array index of the first peak of spectrum @p index with an m/z not smaller than @p mz
+    Size MZBegin(Size index, DoubleReal mz) const;
+
+    /// Returns the peak array index of the first peak of spectrum @p index with an m/z larger than @p mz
+    Size MZEnd(Size index, DoubleReal mz) const;
+
+    /**
+      @brief Returns the peak array index of the peak of spectrum @p index nearest to @p mz
+
+      @exception Exception::Precondition is thrown if the spectrum contains no peaks
+    */
+    Size findNearest(Size index, DoubleReal mz) const;
+
+    /**
+      @brief Sums up the intensities of all peaks in an RT and m/z range (of spectra with MS level @p ms_level)
+
+      This is the typical access for extracting ion chromatograms and only touches the peaks inside the m/z range.
+    */
+    DoubleReal sumIntensity(DoubleReal min_rt, DoubleReal max_rt, DoubleReal min_mz, DoubleReal max_mz, UInt ms_level = 1) const;
+    //@}
+
+protected:
+    /// Retention times of the spectra
+    std::vector<DoubleReal> rt_;
+    /// MS levels of the spectra
+    std::vector<UInt> ms_level_;
+    /// Native IDs of the spectra
+    std::vector<String> native_id_;
+    /// Start of each spectrum in the peak arrays (with an additional entry for the end of the last spectrum)
+    std::vector<Size> offsets_;
+    /// m/z values of all peaks
+    std::vector<DoubleReal> mz_;
+    /// intensities of all peaks
+    std::vector<Real> intensity_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_KERNEL_PEAKARRAYEXPERIMENT_H
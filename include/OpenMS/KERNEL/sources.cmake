@@ -22,6 +22,7 @@ MSChromatogram.h
 MSExperiment.h
 MSSpectrum.h
 Peak1D.h
+PeakArrayExperiment.h
 Peak2D.h
 PeakIndex.h
 RangeManager.h
@@ -37,6 +37,11 @@
 
 #include <map>
 #include <string>
+#include <vector>
+
+#include <boost/unordered/unordered_map.hpp>
+
+#include <QtCore/QThreadStorage>
 
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Types.h>
@@ -69,6 +74,10 @@ namespace OpenMS
       12 - low_quality<BR>
       13 - charge<BR>
 
+      Names and indices never change once they are registered. Therefore each thread keeps a private cache
+      (in thread-local storage) of the names and indices it has looked up, and getIndex() / getName() only
+      synchronize with other threads when a name is seen by the thread for the first time.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfoRegistry
@@ -163,16 +172,43 @@ public:
     String getUnit(const String & name) const;
 
 private:
+    /// hashed map from name to index
+    typedef boost::unordered_map<std::string, UInt> NameToIndexMap_;
+
+    /// Lookup cache of one thread
+    struct ThreadCache_
+    {
+      ThreadCache_() :
+        generation(0)
+      {
+      }
+
+      /// the cache is outdated if this differs from MetaInfoRegistry::cache_generation_
+      UInt generation;
+      NameToIndexMap_ name_to_index;
+      boost::unordered_map<UInt, String> index_to_name;
+    };
+
+    /// Returns the cache of the calling thread (created on first use)
+    ThreadCache_ * getThreadCache_() const;
+
+    /// Invalidates the caches of all threads
+    void clearThreadCaches_();
+
     /// internal counter, that stores the next index to assign
     mutable UInt next_index_;
     /// map from name to index
-    mutable std::map<String, UInt> name_to_index_;
+    mutable NameToIndexMap_ name_to_index_;
     /// map from index to name
     mutable std::map<UInt, String> index_to_name_;
     /// map from index to description
     mutable std::map<UInt, String> index_to_description_;
     /// map from index to unit
     mutable std::map<UInt, String> index_to_unit_;
+    /// generation of the thread caches, incremented whenever the registry is assigned
+    UInt cache_generation_;
+    /// lookup caches, one per thread (the cache of a thread is deleted when the thread ends)
+    mutable QThreadStorage<ThreadCache_ *> thread_caches_;
 
   };
 
@@ -93,6 +93,13 @@ protected:
     enum PROFILESHAPE {RT_RECTANGULAR, RT_GAUSSIAN};
     enum RESOLUTIONMODEL {RES_CONSTANT, RES_LINEAR, RES_SQRT};
 
+    /**
+     @brief Peak containers (one per scan of an LC/MS map) that receive sampled signals
+
+     These are either the scans of an experiment or per-thread buffers. The scan meta data (RT etc.)
+     is always read from the shared experiment.
+     */
+    typedef std::vector<MSSimExperiment::SpectrumType::ContainerType *> ScanPeaks_;
 
     /// Default constructor
     RawMSSignalSimulation();
@@ -121,6 +128,16 @@ protected:
      */
     void add2DSignal_(Feature & feature, MSSimExperiment & experiment, MSSimExperiment & experiment_ct);
 
+    /**
+     @brief Add a 2D signal for a single feature
+
+     @param feature The feature which should be simulated
+     @param experiment The experiment that defines the scans (only read)
+     @param peaks Containers (one per scan of @p experiment) to which the simulated signals should be added
+     @param peaks_ct Containers (one per scan of @p experiment) to which the ground truth for picked peaks should be added
+     */
+    void add2DSignal_(Feature & feature, const MSSimExperiment & experiment, ScanPeaks_ & peaks, ScanPeaks_ & peaks_ct);
+
     /**
      @brief Samples signals for the given 1D model
 
@@ -146,8 +163,9 @@ protected:
      @param mz_end End coordinate (in m/z dimension) of the region where the signals will be sampled
      @param rt_start Start coordinate (in rt dimension) of the region where the signals will be sampled
      @param rt_end End coordinate (in rt dimension) of the region where the signals will be sampled
-     @param experiment Experiment to which the sampled signals will be added
-     @param experiment_ct Experiment to which the centroided Ground Truth sampled signals will be added
+     @param experiment Experiment that defines the scans (only read)
+     @param peaks Containers (one per scan of @p experiment) to which the sampled signals will be added
+     @param peaks_ct Containers (one per scan of @p experiment) to which the centroided Ground Truth sampled signals will be added
      @param activeFeature The current feature that is simulated
      */
     void samplePeptideModel2D_(const ProductModel<2> & pm,
@@ -155,8 +173,9 @@ protected:
                                const SimCoordinateType mz_end,
                                SimCoordinateType rt_start,
                                SimCoordinateType rt_end,
-                               MSSimExperiment & experiment,
-                               MSSimExperiment & experiment_ct,
+                               const MSSimExperiment & experiment,
+                               ScanPeaks_ & peaks,
+                               ScanPeaks_ & peaks_ct,
                                Feature & activeFeature);
 
     /**
@@ -187,6 +206,12 @@ protected:
     /// Compress signales in a single RT scan (to merge signals which were sampled overlapping)
     void compressSignals_(MSSimExperiment & experiment);
 
+    /// Compresses the peaks of each scan onto the sampling grid between @p min_mz and @p max_mz (only the peaks are modified)
+    void compressSignals_(ScanPeaks_ & scans, const SimCoordinateType min_mz, const SimCoordinateType max_mz);
+
+    /// Returns the peak containers of all scans of @p experiment
+    static ScanPeaks_ getScanPeaks_(MSSimExperiment & experiment);
+
     /// number of points sampled per peak's FWHM
     Int sampling_points_per_FWHM_;
 
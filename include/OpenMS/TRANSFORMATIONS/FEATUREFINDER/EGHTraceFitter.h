@@ -251,104 +251,84 @@ protected:
       fwhm_bound_ = getAlphaBoundaries_(0.45783);
     }
 
+    typedef typename TraceFitter<PeakType>::ModelData ModelData;
+
     static Int residual_(const gsl_vector * param, void * data, gsl_vector * f)
     {
-      FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> * traces = static_cast<FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> *>(data);
-
-      double H  = gsl_vector_get(param, 0);
-      double tR = gsl_vector_get(param, 1);
-      double sigma_square = gsl_vector_get(param, 2);
-      double tau = gsl_vector_get(param, 3);
-
-      double t_diff, t_diff2, denominator = 0.0;
-
-      double fegh = 0.0;
-
-      UInt count = 0;
-      for (Size t = 0; t < traces->size(); ++t)
+      const ModelData * model_data = static_cast<const ModelData *>(data);
+
+      const double H  = gsl_vector_get(param, 0);
+      const double tR = gsl_vector_get(param, 1);
+      const double sigma_square = gsl_vector_get(param, 2);
+      const double tau = gsl_vector_get(param, 3);
+
+      const double * rt = &model_data->rt[0];
+      const double * intensity = &model_data->intensity[0];
+      const double * theoretical_int = &model_data->theoretical_int[0];
+      const double baseline = model_data->baseline;
+      double * f_data = f->data;
+      const Size f_stride = f->stride;
+      for (Size i = 0; i < model_data->size; ++i)
       {
-        FeatureFinderAlgorithmPickedHelperStructs::MassTrace<PeakType> & trace = traces->at(t);
-        for (Size i = 0; i < trace.peaks.size(); ++i)
-        {
-          DoubleReal rt = trace.peaks[i].first;
-
-          t_diff = rt - tR;
-          t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
+        const double t_diff = rt[i] - tR;
+        const double t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
+        const double denominator = 2 * sigma_square + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
 
-          denominator = 2 * sigma_square + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
-
-          if (denominator > 0.0)
-          {
-            fegh =  traces->baseline + trace.theoretical_int * H * exp(-t_diff2 / denominator);
-          }
-          else
-          {
-            fegh = 0.0;
-          }
-
-          gsl_vector_set(f, count, (fegh - trace.peaks[i].second->getIntensity()));
-          ++count;
+        double fegh = 0.0;
+        if (denominator > 0.0)
+        {
+          fegh = baseline + theoretical_int[i] * H * exp(-t_diff2 / denominator);
         }
+        f_data[i * f_stride] = fegh - intensity[i];
       }
       return GSL_SUCCESS;
     }
 
-    static Int jacobian_(const gsl_vector * param, void * data, gsl_matrix * J)
+    /// Writes the partial derivatives of the EGH at one data point to @p row
+    static inline void derivatives_(const double theoretical_int, const double H, const double sigma_square, const double t_diff, const double t_diff2, const double denominator, const double exp1, double * row)
     {
-      FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> * traces = static_cast<FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> *>(data);
-
-      double H  = gsl_vector_get(param, 0);
-      double tR = gsl_vector_get(param, 1);
-      double sigma_square = gsl_vector_get(param, 2);
-      double tau = gsl_vector_get(param, 3);
-
-      double derivative_H, derivative_tR, derivative_sigma_square, derivative_tau = 0.0;
-      double t_diff, t_diff2, exp1, denominator = 0.0;
-
-      UInt count = 0;
-      for (Size t = 0; t < traces->size(); ++t)
-      {
-        FeatureFinderAlgorithmPickedHelperStructs::MassTrace<PeakType> & trace = traces->at(t);
-        for (Size i = 0; i < trace.peaks.size(); ++i)
-        {
-          DoubleReal rt = trace.peaks[i].first;
+      // \partial H f_{egh}(t) = \exp\left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right)
+      row[0] = theoretical_int * exp1;
 
-          t_diff = rt - tR;
-          t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
+      const double factor = theoretical_int * H * exp1 / (denominator * denominator);
 
-          denominator = 2 * sigma_square + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
+      // \partial t_R f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{\left( 4 \sigma_{g}^{2} + \tau \left(t-t_R \right) \right) \left(t-t_R \right)}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
+      row[1] = factor * (2 * sigma_square + denominator) * t_diff;
 
-          if (denominator > 0)
-          {
-            exp1 = exp(-t_diff2 / denominator);
+      // \partial \sigma_{g}^{2} f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ 2 \left(t - t_R\right)^2}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
+      row[2] = factor * 2 * t_diff2;
 
-            // \partial H f_{egh}(t) = \exp\left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right)
-            derivative_H = trace.theoretical_int * exp1;
-
-            // \partial t_R f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{\left( 4 \sigma_{g}^{2} + \tau \left(t-t_R \right) \right) \left(t-t_R \right)}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-            derivative_tR = trace.theoretical_int * H * exp1 * (((4 * sigma_square + tau * t_diff) * t_diff) / (denominator * denominator));
-
-            // \partial \sigma_{g}^{2} f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ 2 \left(t - t_R\right)^2}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-            derivative_sigma_square = trace.theoretical_int * H * exp1 * ((2 * t_diff2) / (denominator * denominator));
-
-            // \partial \tau f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ \left(t - t_R\right)^3}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
-            derivative_tau = trace.theoretical_int * H * exp1 * ((t_diff * t_diff2) / (denominator * denominator));
-          }
-          else
-          {
-            derivative_H = 0.0;
-            derivative_tR = 0.0;
-            derivative_sigma_square = 0.0;
-            derivative_tau = 0.0;
-          }
+      // \partial \tau f_{egh}(t) &=& H \exp \left( \frac{-\left(t-t_R \right)^2}{2\sigma_{g}^{2} + \tau \left(t - t_R\right)} \right) \left( \frac{ \left(t - t_R\right)^3}{\left( 2\sigma_{g}^{2} + \tau \left(t - t_R\right) \right)^2} \right)
+      row[3] = factor * t_diff * t_diff2;
+    }
 
-          // set the jacobian matrix
-          gsl_matrix_set(J, count, 0, derivative_H);
-          gsl_matrix_set(J, count, 1, derivative_tR);
-          gsl_matrix_set(J, count, 2, derivative_sigma_square);
-          gsl_matrix_set(J, count, 3, derivative_tau);
+    static Int jacobian_(const gsl_vector * param, void * data, gsl_matrix * J)
+    {
+      const ModelData * model_data = static_cast<const ModelData *>(data);
+
+      const double H  = gsl_vector_get(param, 0);
+      const double tR = gsl_vector_get(param, 1);
+      const double sigma_square = gsl_vector_get(param, 2);
+      const double tau = gsl_vector_get(param, 3);
+
+      const double * rt = &model_data->rt[0];
+      const double * theoretical_int = &model_data->theoretical_int[0];
+      double * J_data = J->data;
+      const Size J_tda = J->tda;
+      for (Size i = 0; i < model_data->size; ++i)
+      {
+        const double t_diff = rt[i] - tR;
+        const double t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
+        const double denominator = 2 * sigma_square + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
 
-          ++count;
+        double * row = J_data + i * J_tda;
+        if (denominator > 0.0)
+        {
+          derivatives_(theoretical_int[i], H, sigma_square, t_diff, t_diff2, denominator, exp(-t_diff2 / denominator), row);
+        }
+        else
+        {
+          row[0] = row[1] = row[2] = row[3] = 0.0;
         }
       }
       return GSL_SUCCESS;
@@ -356,8 +336,41 @@ protected:
 
     static Int evaluate_(const gsl_vector * param, void * data, gsl_vector * f, gsl_matrix * J)
     {
-      residual_(param, data, f);
-      jacobian_(param, data, J);
+      // residuals and derivatives share the exponential, so compute both in one pass
+      const ModelData * model_data = static_cast<const ModelData *>(data);
+
+      const double H  = gsl_vector_get(param, 0);
+      const double tR = gsl_vector_get(param, 1);
+      const double sigma_square = gsl_vector_get(param, 2);
+      const double tau = gsl_vector_get(param, 3);
+
+      const double * rt = &model_data->rt[0];
+      const double * intensity = &model_data->intensity[0];
+      const double * theoretical_int = &model_data->theoretical_int[0];
+      const double baseline = model_data->baseline;
+      double * f_data = f->data;
+      const Size f_stride = f->stride;
+      double * J_data = J->data;
+      const Size J_tda = J->tda;
+      for (Size i = 0; i < model_data->size; ++i)
+      {
+        const double t_diff = rt[i] - tR;
+        const double t_diff2 = t_diff * t_diff; // -> (t - t_R)^2
+        const double denominator = 2 * sigma_square + tau * t_diff; // -> 2\sigma_{g}^{2} + \tau \left(t - t_R\right)
+
+        double * row = J_data + i * J_tda;
+        if (denominator > 0.0)
+        {
+          const double exp1 = exp(-t_diff2 / denominator);
+          f_data[i * f_stride] = baseline + theoretical_int[i] * H * exp1 - intensity[i];
+          derivatives_(theoretical_int[i], H, sigma_square, t_diff, t_diff2, denominator, exp1, row);
+        }
+        else
+        {
+          f_data[i * f_stride] = -intensity[i];
+          row[0] = row[1] = row[2] = row[3] = 0.0;
+        }
+      }
       return GSL_SUCCESS;
     }
 
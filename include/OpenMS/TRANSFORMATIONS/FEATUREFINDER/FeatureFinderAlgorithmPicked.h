@@ -48,6 +48,7 @@
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/ParallelExceptionHandler.h>
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
@@ -57,6 +58,8 @@
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <limits>
+#include <map>
 
 #include <QtCore/QDir>
 
@@ -272,6 +275,13 @@ public:
       trace_fitter_params.setValue("epsilon_abs", epsilon_abs);
       trace_fitter_params.setValue("epsilon_rel", epsilon_rel);
 
+      // one optimization workspace per thread, so the fitters do not allocate a new solver for every feature
+#ifdef _OPENMP
+      std::vector<typename TraceFitter<PeakType>::Workspace> fit_workspaces(omp_get_max_threads());
+#else
+      std::vector<typename TraceFitter<PeakType>::Workspace> fit_workspaces(1);
+#endif
+
       //copy the input map
       map_ = *(FeatureFinderAlgorithm<PeakType, FeatureType>::map_);
 
@@ -285,35 +295,15 @@ public:
       DoubleReal user_mz_tol = param_.getValue("user-seed:mz_tolerance");
       DoubleReal user_seed_score = param_.getValue("user-seed:min_score");
 
-      //reserve space for calculated scores
+      //reserve space for calculated scores (kept next to the map instead of in its data arrays):
+      //0: trace score, 1: intensity score, 2: local maximum, then pattern score and overall score for each charge
       UInt charge_count = charge_high - charge_low + 1;
+      peak_offsets_.assign(map_.size() + 1, 0);
       for (Size s = 0; s < map_.size(); ++s)
       {
-        Size scan_size = map_[s].size();
-        map_[s].getFloatDataArrays().resize(3 + 2 * charge_count);
-        map_[s].getFloatDataArrays()[0].setName("trace_score");
-        map_[s].getFloatDataArrays()[0].assign(scan_size, 0.0);
-        map_[s].getFloatDataArrays()[1].setName("intensity_score");
-        map_[s].getFloatDataArrays()[1].assign(scan_size, 0.0);
-        map_[s].getFloatDataArrays()[2].setName("local_max");
-        map_[s].getFloatDataArrays()[2].assign(scan_size, 0.0);
-        //create isotope pattern score arrays
-        UInt charge = charge_low;
-        for (Size i = 3; i < 3 + charge_count; ++i)
-        {
-          map_[s].getFloatDataArrays()[i].setName(String("pattern_score_") + charge);
-          map_[s].getFloatDataArrays()[i].assign(scan_size, 0.0);
-          ++charge;
-        }
-        //create overall score arrays
-        charge = charge_low;
-        for (Size i = 3 + charge_count; i < 3 + 2 * charge_count; ++i)
-        {
-          map_[s].getFloatDataArrays()[i].setName(String("overall_score_") + charge);
-          map_[s].getFloatDataArrays()[i].assign(scan_size, 0.0);
-          ++charge;
-        }
+        peak_offsets_[s + 1] = peak_offsets_[s] + map_[s].size();
       }
+      scores_.assign(3 + 2 * charge_count, std::vector<Real>(peak_offsets_.back(), 0.0));
 
       int gl_progress = 0;
       debug_ = ((String)(param_.getValue("debug")) == "true");
@@ -338,7 +328,11 @@ public:
         intensity_rt_step_ = (map_.getMaxRT() - rt_start) / (DoubleReal)intensity_bins_;
         intensity_mz_step_ = (map_.getMaxMZ() - mz_start) / (DoubleReal)intensity_bins_;
         intensity_thresholds_.resize(intensity_bins_);
-        for (Size rt = 0; rt < intensity_bins_; ++rt)
+        Size progress = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize rt = 0; rt < (SignedSize)intensity_bins_; ++rt)
         {
           intensity_thresholds_[rt].resize(intensity_bins_);
           DoubleReal min_rt = rt_start + rt * intensity_rt_step_;
@@ -346,7 +340,6 @@ public:
           std::vector<DoubleReal> tmp;
           for (Size mz = 0; mz < intensity_bins_; ++mz)
           {
-            ff_->setProgress(rt * intensity_bins_ + mz);
             DoubleReal min_mz = mz_start + mz * intensity_mz_step_;
             DoubleReal max_mz = mz_start + (mz + 1) * intensity_mz_step_;
             //std::cout << "rt range: " << min_rt << " - " << max_rt << std::endl;
@@ -369,14 +362,24 @@ public:
               }
             }
           }
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderAlgorithmPicked_PROGRESS)
+#endif
+          {
+            progress += intensity_bins_;
+            ff_->setProgress(progress);
+          }
         }
 
-        //store intensity score in PeakInfo
-        for (Size s = 0; s < map_.size(); ++s)
+        //store intensity score of each peak
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize s = 0; s < (SignedSize)map_.size(); ++s)
         {
           for (Size p = 0; p < map_[s].size(); ++p)
           {
-            map_[s].getFloatDataArrays()[1][p] = intensityScore_(s, p);
+            peakScore_(1, s, p) = intensityScore_(s, p);
           }
         }
         ff_->endProgress();
@@ -390,10 +393,17 @@ public:
       {
         Size end_iteration = map_.size() - std::min((Size) min_spectra_, map_.size());
         ff_->startProgress(min_spectra_, end_iteration, "Precalculating mass trace scores");
+        Size progress = min_spectra_;
         // skip first and last scans since we cannot extend the mass traces there
-        for (Size s = min_spectra_; s < end_iteration; ++s)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize s = min_spectra_; s < (SignedSize)end_iteration; ++s)
         {
-          ff_->setProgress(s);
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderAlgorithmPicked_PROGRESS)
+#endif
+          ff_->setProgress(++progress);
           const SpectrumType& spectrum = map_[s];
           //iterate over all peaks of the scan
           for (Size p = 0; p < spectrum.size(); ++p)
@@ -438,8 +448,8 @@ public:
             DoubleReal trace_score = std::accumulate(scores.begin(), scores.end(), 0.0) / scores.size();
 
             //store final score for later use
-            map_[s].getFloatDataArrays()[0][p] = trace_score;
-            map_[s].getFloatDataArrays()[2][p] = is_max_peak;
+            peakScore_(0, s, p) = trace_score;
+            peakScore_(2, s, p) = is_max_peak;
           }
         }
         ff_->endProgress();
@@ -537,44 +547,75 @@ public:
         //Step 3.1: Precalculate IsotopePattern score
         //-----------------------------------------------------------
         ff_->startProgress(0, map_.size(), String("Calculating isotope pattern scores for charge ") + String(c));
-        for (Size s = 0; s < map_.size(); ++s)
+        Size progress = 0;
+        std::vector<Real>& pattern_scores = scores_[meta_index_isotope];
+        //exceptions must not leave the parallel region, the one of the first failing spectrum is rethrown afterwards
+        ParallelExceptionHandler error;
+        //in debug mode the isotope search writes to the log, so keep its order
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (!debug_)
+#endif
+        for (SignedSize s = 0; s < (SignedSize)map_.size(); ++s)
         {
-          ff_->setProgress(s);
-          const SpectrumType& spectrum = map_[s];
-          for (Size p = 0; p < spectrum.size(); ++p)
+          try
           {
-            DoubleReal mz = spectrum[p].getMZ();
+            const SpectrumType& spectrum = map_[s];
+            //patterns also contain peaks of the neighboring spectra, collect their scores and update them at once
+            std::vector<std::pair<Size, DoubleReal> > updates;
+            for (Size p = 0; p < spectrum.size(); ++p)
+            {
+              DoubleReal mz = spectrum[p].getMZ();
 
-            //get isotope distribution for this mass
-            const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(mz * c);
-            //determine highest peak in isotope distribution
-            Size max_isotope = std::max_element(isotopes.intensity.begin(), isotopes.intensity.end()) - isotopes.intensity.begin();
-            //Look up expected isotopic peaks (in the current spectrum or adjacent spectra)
-            Size peak_index = spectrum.findNearest(mz - ((DoubleReal)(isotopes.size() + 1) / c));
-            IsotopePattern pattern(isotopes.size());
+              //get isotope distribution for this mass
+              const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(mz * c);
+              //determine highest peak in isotope distribution
+              Size max_isotope = std::max_element(isotopes.intensity.begin(), isotopes.intensity.end()) - isotopes.intensity.begin();
+              //Look up expected isotopic peaks (in the current spectrum or adjacent spectra)
+              Size peak_index = spectrum.findNearest(mz - ((DoubleReal)(isotopes.size() + 1) / c));
+              IsotopePattern pattern(isotopes.size());
 
-            for (Size i = 0; i < isotopes.size(); ++i)
-            {
-              DoubleReal isotope_pos = mz + ((DoubleReal)i - max_isotope) / c;
-              findIsotope_(isotope_pos, s, pattern, i, peak_index);
-            }
+              for (Size i = 0; i < isotopes.size(); ++i)
+              {
+                DoubleReal isotope_pos = mz + ((DoubleReal)i - max_isotope) / c;
+                findIsotope_(isotope_pos, s, pattern, i, peak_index);
+              }
 
-            DoubleReal pattern_score = isotopeScore_(isotopes, pattern, true);
+              DoubleReal pattern_score = isotopeScore_(isotopes, pattern, true);
 
-            //update pattern scores of all contained peaks (if necessary)
-            if (pattern_score > 0.0)
+              //update pattern scores of all contained peaks (if necessary)
+              if (pattern_score > 0.0)
+              {
+                for (Size i = 0; i < pattern.peak.size(); ++i)
+                {
+                  if (pattern.peak[i] >= 0)
+                  {
+                    updates.push_back(std::make_pair(peak_offsets_[pattern.spectrum[i]] + pattern.peak[i], pattern_score));
+                  }
+                }
+              }
+            }
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderAlgorithmPicked_PATTERNSCORE)
+#endif
             {
-              for (Size i = 0; i < pattern.peak.size(); ++i)
+              //keeping the maximum does not depend on the order of the updates
+              for (Size i = 0; i < updates.size(); ++i)
               {
-                if (pattern.peak[i] >= 0 && pattern_score > map_[pattern.spectrum[i]].getFloatDataArrays()[meta_index_isotope][pattern.peak[i]])
+                if (updates[i].second > pattern_scores[updates[i].first])
                 {
-                  map_[pattern.spectrum[i]].getFloatDataArrays()[meta_index_isotope][pattern.peak[i]] = pattern_score;
+                  pattern_scores[updates[i].first] = updates[i].second;
                 }
               }
+              ff_->setProgress(++progress);
             }
           }
+          catch (...)
+          {
+            error.capture(s);
+          }
         }
         ff_->endProgress();
+        error.rethrow();
         //-----------------------------------------------------------
         //Step 3.2:
         //Find seeds for this charge
@@ -583,20 +624,28 @@ public:
         ff_->startProgress(min_spectra_, end_of_iteration, String("Finding seeds for charge ") + String(c));
 
         DoubleReal min_seed_score = param_.getValue("seed:min_score");
+        //seeds are collected per spectrum and concatenated in spectrum order afterwards
+        std::vector<std::vector<Seed> > spectrum_seeds(map_.size());
+        progress = min_spectra_;
         //do nothing for the first few and last few spectra as the scans required to search for traces are missing
-        for (Size s = min_spectra_; s < end_of_iteration; ++s)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize s = min_spectra_; s < (SignedSize)end_of_iteration; ++s)
         {
-          ff_->setProgress(s);
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderAlgorithmPicked_PROGRESS)
+#endif
+          ff_->setProgress(++progress);
 
           //iterate over peaks
           for (Size p = 0; p < map_[s].size(); ++p)
           {
-            FloatDataArrays& meta = map_[s].getFloatDataArrays();
-            DoubleReal overall_score = std::pow(meta[0][p] * meta[1][p] * meta[meta_index_isotope][p], 1.0f / 3.0f);
-            meta[meta_index_overall][p] = overall_score;
+            DoubleReal overall_score = std::pow(peakScore_(0, s, p) * peakScore_(1, s, p) * peakScore_(meta_index_isotope, s, p), 1.0f / 3.0f);
+            peakScore_(meta_index_overall, s, p) = overall_score;
 
             //add seed to vector if certain conditions are fulfilled
-            if (meta[2][p] != 0.0) // local maximum of mass trace is prerequisite for all features
+            if (peakScore_(2, s, p) != 0.0) // local maximum of mass trace is prerequisite for all features
             {
               //automatic seeds: overall score greater than the min seed score
               if (!user_seeds && overall_score >= min_seed_score)
@@ -605,7 +654,7 @@ public:
                 seed.spectrum = s;
                 seed.peak = p;
                 seed.intensity = map_[s][p].getIntensity();
-                seeds.push_back(seed);
+                spectrum_seeds[s].push_back(seed);
               }
               //user-specified seeds: overall score greater than USER min seed score
               else if (user_seeds && overall_score >= user_seed_score)
@@ -626,7 +675,7 @@ public:
                     seed.spectrum = s;
                     seed.peak = p;
                     seed.intensity = map_[s][p].getIntensity();
-                    seeds.push_back(seed);
+                    spectrum_seeds[s].push_back(seed);
                     break;
                   }
                 }
@@ -634,6 +683,10 @@ public:
             }
           }
         }
+        for (Size s = 0; s < spectrum_seeds.size(); ++s)
+        {
+          seeds.insert(seeds.end(), spectrum_seeds[s].begin(), spectrum_seeds[s].end());
+        }
         //sort seeds according to intensity
         std::sort(seeds.rbegin(), seeds.rend());
         //create and store seeds map and selected peak map
@@ -646,15 +699,14 @@ public:
           {
             Size spectrum = seeds[i].spectrum;
             Size peak = seeds[i].peak;
-            const FloatDataArrays& meta = map_[spectrum].getFloatDataArrays();
             Feature tmp;
             tmp.setIntensity(seeds[i].intensity);
-            tmp.setOverallQuality(meta[meta_index_overall][peak]);
+            tmp.setOverallQuality(peakScore_(meta_index_overall, spectrum, peak));
             tmp.setRT(map_[spectrum].getRT());
             tmp.setMZ(map_[spectrum][peak].getMZ());
-            tmp.setMetaValue("intensity_score", meta[1][peak]);
-            tmp.setMetaValue("pattern_score", meta[meta_index_isotope][peak]);
-            tmp.setMetaValue("trace_score", meta[0][peak]);
+            tmp.setMetaValue("intensity_score", peakScore_(1, spectrum, peak));
+            tmp.setMetaValue("pattern_score", peakScore_(meta_index_isotope, spectrum, peak));
+            tmp.setMetaValue("trace_score", peakScore_(0, spectrum, peak));
             seed_map.push_back(tmp);
           }
           FeatureXMLFile().store(String("debug/seeds_") + String(c) + ".featureXML", seed_map);
@@ -764,6 +816,11 @@ public:
               TraceFitter<PeakType>* fitter = chooseTraceFitter_(egh_tau);
 
               fitter->setParameters(trace_fitter_params);
+#ifdef _OPENMP
+              fitter->setWorkspace(&fit_workspaces[omp_get_thread_num()]);
+#else
+              fitter->setWorkspace(&fit_workspaces[0]);
+#endif
               fitter->fit(traces);
 
 #if 0
@@ -962,87 +1019,153 @@ public:
       //Step 4:
       //Resolve contradicting and overlapping features
       //------------------------------------------------------------------
-      ff_->startProgress(0, features_->size() * features_->size(), "Resolving overlapping features");
+      ff_->startProgress(0, features_->size(), "Resolving overlapping features");
       if (debug_) log_ << "Resolving intersecting features (" << features_->size() << " candidates)" << std::endl;
       //sort features according to m/z in order to speed up the resolution
       features_->sortByMZ();
-      //precalculate BBs and maximum mz span
+      //precalculate BBs (overall and per mass trace) and the maximum extent of a feature
       std::vector<DBoundingBox<2> > bbs(features_->size());
+      std::vector<std::vector<DBoundingBox<2> > > hull_bbs(features_->size());
       DoubleReal max_mz_span = 0.0;
+      DoubleReal max_rt_span = 0.0;
 
       for (Size i = 0; i < features_->size(); ++i)
       {
         bbs[i] = (*features_)[i].getConvexHull().getBoundingBox();
-        if (bbs[i].height() > max_mz_span)
+        max_mz_span = std::max(max_mz_span, bbs[i].height());
+        max_rt_span = std::max(max_rt_span, bbs[i].width());
+        const std::vector<ConvexHull2D>& hulls = (*features_)[i].getConvexHulls();
+        hull_bbs[i].reserve(hulls.size());
+        for (Size h = 0; h < hulls.size(); ++h)
+        {
+          hull_bbs[i].push_back(hulls[h].getBoundingBox());
+        }
+      }
+
+      //index the BBs in a grid with cells at least as large as the largest BB (each BB touches at most 2x2 cells)
+      typedef std::map<std::pair<Int, Int>, std::vector<Size> > GridType;
+      GridType grid;
+      DoubleReal cell_rt = (max_rt_span > 0.0) ? max_rt_span : 1.0;
+      DoubleReal cell_mz = (max_mz_span > 0.0) ? max_mz_span : 1.0;
+      DoubleReal grid_rt_min = std::numeric_limits<DoubleReal>::max();
+      DoubleReal grid_mz_min = std::numeric_limits<DoubleReal>::max();
+      for (Size i = 0; i < bbs.size(); ++i)
+      {
+        grid_rt_min = std::min(grid_rt_min, bbs[i].minPosition()[0]);
+        grid_mz_min = std::min(grid_mz_min, bbs[i].minPosition()[1]);
+      }
+      for (Size i = 0; i < bbs.size(); ++i)
+      {
+        Int rt_first = (Int)((bbs[i].minPosition()[0] - grid_rt_min) / cell_rt), rt_last = (Int)((bbs[i].maxPosition()[0] - grid_rt_min) / cell_rt);
+        Int mz_first = (Int)((bbs[i].minPosition()[1] - grid_mz_min) / cell_mz), mz_last = (Int)((bbs[i].maxPosition()[1] - grid_mz_min) / cell_mz);
+        for (Int rt_cell = rt_first; rt_cell <= rt_last; ++rt_cell)
         {
-          max_mz_span = bbs[i].height();
+          for (Int mz_cell = mz_first; mz_cell <= mz_last; ++mz_cell)
+          {
+            grid[std::make_pair(rt_cell, mz_cell)].push_back(i);
+          }
         }
       }
 
+      //find all intersecting pairs (i < j) in parallel, the intersection only depends on the hulls
+      std::vector<std::vector<std::pair<Size, DoubleReal> > > intersecting(features_->size());
+      Size progress = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)features_->size(); ++i)
+      {
+        Int rt_first = (Int)((bbs[i].minPosition()[0] - grid_rt_min) / cell_rt), rt_last = (Int)((bbs[i].maxPosition()[0] - grid_rt_min) / cell_rt);
+        Int mz_first = (Int)((bbs[i].minPosition()[1] - grid_mz_min) / cell_mz), mz_last = (Int)((bbs[i].maxPosition()[1] - grid_mz_min) / cell_mz);
+        std::vector<Size> candidates;
+        for (Int rt_cell = rt_first; rt_cell <= rt_last; ++rt_cell)
+        {
+          for (Int mz_cell = mz_first; mz_cell <= mz_last; ++mz_cell)
+          {
+            const std::vector<Size>& cell = grid.find(std::make_pair(rt_cell, mz_cell))->second;
+            for (Size k = 0; k < cell.size(); ++k)
+            {
+              if (cell[k] > (Size)i) candidates.push_back(cell[k]);
+            }
+          }
+        }
+        //a pair can share several cells
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (Size k = 0; k < candidates.size(); ++k)
+        {
+          Size j = candidates[k];
+          //do nothing if the overall convex hulls do not overlap
+          if (!bbs[i].intersects(bbs[j])) continue;
+          DoubleReal intersection = intersection_(hull_bbs[i], hull_bbs[j]);
+          if (intersection >= max_feature_intersection_)
+          {
+            intersecting[i].push_back(std::make_pair(j, intersection));
+          }
+        }
+#ifdef _OPENMP
+#pragma omp critical (FeatureFinderAlgorithmPicked_PROGRESS)
+#endif
+        ff_->setProgress(++progress);
+      }
+
       Size removed(0);
-      //intersect
+      //resolve the intersections in the same order as a pairwise scan over the m/z sorted features
       for (Size i = 0; i < features_->size(); ++i)
       {
         Feature& f1((*features_)[i]);
-        for (Size j = i + 1; j < features_->size(); ++j)
+        for (Size k = 0; k < intersecting[i].size(); ++k)
         {
-          ff_->setProgress(i * features_->size() + j);
+          Size j = intersecting[i][k].first;
           Feature& f2((*features_)[j]);
-          //features that are more than 2 times the maximum m/z span apart do not overlap => abort
-          if (f2.getMZ() - f1.getMZ() > 2.0 * max_mz_span) break;
           //do nothing if one of the features is already removed
           if (f1.getIntensity() == 0.0 || f2.getIntensity() == 0.0) continue;
-          //do nothing if the overall convex hulls do not overlap
-          if (!bbs[i].intersects(bbs[j])) continue;
           //act depending on the intersection
-          DoubleReal intersection = intersection_(f1, f2);
+          DoubleReal intersection = intersecting[i][k].second;
+          ++removed;
 
-          if (intersection >= max_feature_intersection_)
+          if (debug_) log_ << " - Intersection (" << (i + 1) << "/" << (j + 1) << "): " << intersection << std::endl;
+          if (f1.getCharge() == f2.getCharge())
           {
-            ++removed;
-
-            if (debug_) log_ << " - Intersection (" << (i + 1) << "/" << (j + 1) << "): " << intersection << std::endl;
-            if (f1.getCharge() == f2.getCharge())
+            if (f1.getIntensity() * f1.getOverallQuality() > f2.getIntensity() * f2.getOverallQuality())
             {
-              if (f1.getIntensity() * f1.getOverallQuality() > f2.getIntensity() * f2.getOverallQuality())
-              {
-                if (debug_) log_ << "   - same charge -> removing duplicate " << (j + 1) << std::endl;
-                f1.getSubordinates().push_back(f2);
-                f2.setIntensity(0.0);
-              }
-              else
-              {
-                if (debug_) log_ << "   - same charge -> removing duplicate " << (i + 1) << std::endl;
-                f2.getSubordinates().push_back(f1);
-                f1.setIntensity(0.0);
-              }
+              if (debug_) log_ << "   - same charge -> removing duplicate " << (j + 1) << std::endl;
+              f1.getSubordinates().push_back(f2);
+              f2.setIntensity(0.0);
             }
-            else if (f2.getCharge() % f1.getCharge() == 0)
+            else
             {
-              if (debug_) log_ << "   - different charge (one is the multiple of the other) -> removing lower charge " << (i + 1) << std::endl;
+              if (debug_) log_ << "   - same charge -> removing duplicate " << (i + 1) << std::endl;
               f2.getSubordinates().push_back(f1);
               f1.setIntensity(0.0);
             }
-            else if (f1.getCharge() % f2.getCharge() == 0)
+          }
+          else if (f2.getCharge() % f1.getCharge() == 0)
+          {
+            if (debug_) log_ << "   - different charge (one is the multiple of the other) -> removing lower charge " << (i + 1) << std::endl;
+            f2.getSubordinates().push_back(f1);
+            f1.setIntensity(0.0);
+          }
+          else if (f1.getCharge() % f2.getCharge() == 0)
+          {
+            if (debug_) log_ << "   - different charge (one is the multiple of the other) -> removing lower charge " << (i + 1) << std::endl;
+            f1.getSubordinates().push_back(f2);
+            f2.setIntensity(0.0);
+          }
+          else
+          {
+            if (f1.getOverallQuality() > f2.getOverallQuality())
             {
-              if (debug_) log_ << "   - different charge (one is the multiple of the other) -> removing lower charge " << (i + 1) << std::endl;
+              if (debug_) log_ << "   - different charge -> removing lower score " << (j + 1) << std::endl;
               f1.getSubordinates().push_back(f2);
               f2.setIntensity(0.0);
             }
             else
             {
-              if (f1.getOverallQuality() > f2.getOverallQuality())
-              {
-                if (debug_) log_ << "   - different charge -> removing lower score " << (j + 1) << std::endl;
-                f1.getSubordinates().push_back(f2);
-                f2.setIntensity(0.0);
-              }
-              else
-              {
-                if (debug_) log_ << "   - different charge -> removing lower score " << (i + 1) << std::endl;
-                f2.getSubordinates().push_back(f1);
-                f1.setIntensity(0.0);
-              }
+              if (debug_) log_ << "   - different charge -> removing lower score " << (i + 1) << std::endl;
+              f2.getSubordinates().push_back(f1);
+              f1.setIntensity(0.0);
             }
           }
         }
@@ -1090,10 +1213,21 @@ public:
         abort_map.setUniqueId();
         FeatureXMLFile().store("debug/abort_reasons.featureXML", abort_map);
 
-        //store input map with calculated scores (without overall score)
+        //store input map with calculated scores (without local maximum flag)
         for (Size s = 0; s < map_.size(); ++s)
         {
-          map_[s].getFloatDataArrays().erase(map_[s].getFloatDataArrays().begin() + 2);
+          FloatDataArrays& arrays = map_[s].getFloatDataArrays();
+          arrays.clear();
+          arrays.resize(scores_.size() - 1);
+          for (Size i = 0; i < arrays.size(); ++i)
+          {
+            Size score_index = (i < 2) ? i : i + 1;
+            if (score_index == 0) arrays[i].setName("trace_score");
+            else if (score_index == 1) arrays[i].setName("intensity_score");
+            else if (score_index < 3 + charge_count) arrays[i].setName(String("pattern_score_") + String((Int)(charge_low + score_index - 3)));
+            else arrays[i].setName(String("overall_score_") + String((Int)(charge_low + score_index - 3 - charge_count)));
+            arrays[i].assign(scores_[score_index].begin() + peak_offsets_[s], scores_[score_index].begin() + peak_offsets_[s + 1]);
+          }
         }
         MzMLFile().store("debug/input.mzML", map_);
       }
@@ -1157,6 +1291,26 @@ protected:
     ///Vector of precalculated isotope distributions for several mass windows
     std::vector<TheoreticalIsotopePattern> isotope_distributions_;
 
+    /// @name Members for the precalculated peak scores
+    //@{
+    /// Index of the first peak of each spectrum in the score arrays (one more entry than spectra)
+    std::vector<Size> peak_offsets_;
+    /// Score arrays (trace, intensity, local maximum, pattern and overall score per charge) over all peaks of the map
+    std::vector<std::vector<Real> > scores_;
+    //@}
+
+    /// Returns the score with index @p score_index of peak @p peak in spectrum @p spectrum
+    Real& peakScore_(Size score_index, Size spectrum, Size peak)
+    {
+      return scores_[score_index][peak_offsets_[spectrum] + peak];
+    }
+
+    /// Returns the score with index @p score_index of peak @p peak in spectrum @p spectrum
+    Real peakScore_(Size score_index, Size spectrum, Size peak) const
+    {
+      return scores_[score_index][peak_offsets_[spectrum] + peak];
+    }
+
     // Docu in base class
     virtual void updateMembers_()
     {
@@ -1189,33 +1343,32 @@ protected:
     /**
      * Calculates the intersection between features.
      * The value is normalized by the size of the smaller feature, so it ranges from 0 to 1.
+     * The features are given by the bounding boxes of their mass trace hulls.
      */
-    DoubleReal intersection_(const Feature& f1, const Feature& f2) const
+    DoubleReal intersection_(const std::vector<DBoundingBox<2> >& hulls1, const std::vector<DBoundingBox<2> >& hulls2) const
     {
       //calculate the RT range sum of feature 1
       DoubleReal s1 = 0.0;
-      const std::vector<ConvexHull2D>& hulls1 = f1.getConvexHulls();
       for (Size i = 0; i < hulls1.size(); ++i)
       {
-        s1 += hulls1[i].getBoundingBox().width();
+        s1 += hulls1[i].width();
       }
 
       //calculate the RT range sum of feature 2
       DoubleReal s2 = 0.0;
-      const std::vector<ConvexHull2D>& hulls2 = f2.getConvexHulls();
       for (Size j = 0; j < hulls2.size(); ++j)
       {
-        s2 += hulls2[j].getBoundingBox().width();
+        s2 += hulls2[j].width();
       }
 
       //calculate overlap
       DoubleReal overlap = 0.0;
       for (Size i = 0; i < hulls1.size(); ++i)
       {
-        DBoundingBox<2> bb1 = hulls1[i].getBoundingBox();
+        const DBoundingBox<2>& bb1 = hulls1[i];
         for (Size j = 0; j < hulls2.size(); ++j)
         {
-          DBoundingBox<2> bb2 = hulls2[j].getBoundingBox();
+          const DBoundingBox<2>& bb2 = hulls2[j];
           if (bb1.intersects(bb2))
           {
             if (bb1.minPosition()[0] <= bb2.minPosition()[0] &&
@@ -1564,7 +1717,7 @@ protected:
         // check if the peak is "missing"
         if (
           peak_index < 0 // no peak found
-           || map_[spectrum_index].getFloatDataArrays()[meta_index_overall][peak_index] < 0.01 // overall score is to low
+           || peakScore_(meta_index_overall, spectrum_index, peak_index) < 0.01 // overall score is to low
            || positionScore_(mz, map_[spectrum_index][peak_index].getMZ(), trace_tolerance_) == 0.0 // deviation of mz is too big
           )
         {
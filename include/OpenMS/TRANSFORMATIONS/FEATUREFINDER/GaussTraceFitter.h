@@ -178,58 +178,85 @@ protected:
       sigma_ = std::fabs(gsl_vector_get(s->x, 2));
     }
 
+    typedef typename TraceFitter<PeakType>::ModelData ModelData;
+
     static Int residual_(const gsl_vector * param, void * data, gsl_vector * f)
     {
-      FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> * traces = static_cast<FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> *>(data);
-      double height = gsl_vector_get(param, 0);
-      double x0 = gsl_vector_get(param, 1);
-      double sig = gsl_vector_get(param, 2);
-      double c_fac = -0.5 / pow(sig, 2);
-
-      Size count = 0;
-      for (Size t = 0; t < traces->size(); ++t)
+      const ModelData * model_data = static_cast<const ModelData *>(data);
+      const double height = gsl_vector_get(param, 0);
+      const double x0 = gsl_vector_get(param, 1);
+      const double sig = gsl_vector_get(param, 2);
+      const double c_fac = -0.5 / pow(sig, 2);
+
+      const double * rt = &model_data->rt[0];
+      const double * intensity = &model_data->intensity[0];
+      const double * theoretical_int = &model_data->theoretical_int[0];
+      const double baseline = model_data->baseline;
+      double * f_data = f->data;
+      const Size f_stride = f->stride;
+      for (Size i = 0; i < model_data->size; ++i)
       {
-        const FeatureFinderAlgorithmPickedHelperStructs::MassTrace<PeakType> & trace = (*traces)[t];
-        for (Size i = 0; i < trace.peaks.size(); ++i)
-        {
-          gsl_vector_set(f, count, traces->baseline + trace.theoretical_int * height * exp(c_fac * pow(trace.peaks[i].first - x0, 2)) - trace.peaks[i].second->getIntensity());
-          ++count;
-        }
+        const double diff = rt[i] - x0;
+        f_data[i * f_stride] = baseline + theoretical_int[i] * height * exp(c_fac * diff * diff) - intensity[i];
       }
       return GSL_SUCCESS;
     }
 
     static Int jacobian_(const gsl_vector * param, void * data, gsl_matrix * J)
     {
-      FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> * traces = static_cast<FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> *>(data);
-      double height = gsl_vector_get(param, 0);
-      double x0 = gsl_vector_get(param, 1);
-      double sig = gsl_vector_get(param, 2);
-      double sig_sq = pow(sig, 2);
-      double sig_3 = pow(sig, 3);
-      double c_fac = -0.5 / sig_sq;
-
-      Size count = 0;
-      for (Size t = 0; t < traces->size(); ++t)
+      const ModelData * model_data = static_cast<const ModelData *>(data);
+      const double height = gsl_vector_get(param, 0);
+      const double x0 = gsl_vector_get(param, 1);
+      const double sig = gsl_vector_get(param, 2);
+      const double sig_sq = pow(sig, 2);
+      const double sig_3 = pow(sig, 3);
+      const double c_fac = -0.5 / sig_sq;
+
+      const double * rt = &model_data->rt[0];
+      const double * theoretical_int = &model_data->theoretical_int[0];
+      double * J_data = J->data;
+      const Size J_tda = J->tda;
+      for (Size i = 0; i < model_data->size; ++i)
       {
-        const FeatureFinderAlgorithmPickedHelperStructs::MassTrace<PeakType> & trace = (*traces)[t];
-        for (Size i = 0; i < trace.peaks.size(); ++i)
-        {
-          DoubleReal rt = trace.peaks[i].first;
-          DoubleReal e = exp(c_fac * pow(rt - x0, 2));
-          gsl_matrix_set(J, count, 0, trace.theoretical_int * e);
-          gsl_matrix_set(J, count, 1, trace.theoretical_int * height * e * (rt - x0) / sig_sq);
-          gsl_matrix_set(J, count, 2, 0.125 * trace.theoretical_int * height * e * pow(rt - x0, 2) / sig_3);
-          ++count;
-        }
+        const double diff = rt[i] - x0;
+        const double e = theoretical_int[i] * exp(c_fac * diff * diff);
+        double * row = J_data + i * J_tda;
+        row[0] = e;
+        row[1] = height * e * diff / sig_sq;
+        row[2] = 0.125 * height * e * diff * diff / sig_3;
       }
       return GSL_SUCCESS;
     }
 
     static Int evaluate_(const gsl_vector * param, void * data, gsl_vector * f, gsl_matrix * J)
     {
-      residual_(param, data, f);
-      jacobian_(param, data, J);
+      // residuals and derivatives share the exponential, so compute both in one pass
+      const ModelData * model_data = static_cast<const ModelData *>(data);
+      const double height = gsl_vector_get(param, 0);
+      const double x0 = gsl_vector_get(param, 1);
+      const double sig = gsl_vector_get(param, 2);
+      const double sig_sq = pow(sig, 2);
+      const double sig_3 = pow(sig, 3);
+      const double c_fac = -0.5 / sig_sq;
+
+      const double * rt = &model_data->rt[0];
+      const double * intensity = &model_data->intensity[0];
+      const double * theoretical_int = &model_data->theoretical_int[0];
+      const double baseline = model_data->baseline;
+      double * f_data = f->data;
+      const Size f_stride = f->stride;
+      double * J_data = J->data;
+      const Size J_tda = J->tda;
+      for (Size i = 0; i < model_data->size; ++i)
+      {
+        const double diff = rt[i] - x0;
+        const double e = theoretical_int[i] * exp(c_fac * diff * diff);
+        f_data[i * f_stride] = baseline + height * e - intensity[i];
+        double * row = J_data + i * J_tda;
+        row[0] = e;
+        row[1] = height * e * diff / sig_sq;
+        row[2] = 0.125 * height * e * diff * diff / sig_3;
+      }
       return GSL_SUCCESS;
     }
 
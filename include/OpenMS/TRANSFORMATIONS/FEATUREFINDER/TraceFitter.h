@@ -41,11 +41,17 @@
 
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
-#include <gsl/gsl_rng.h>
+#include <map>
+#include <vector>
+
 #include <gsl/gsl_vector.h>
 #include <gsl/gsl_multifit_nlin.h>
 #include <gsl/gsl_blas.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -64,9 +70,101 @@ namespace OpenMS
   {
 
 public:
+
+    /**
+     * @brief The mass traces flattened into contiguous arrays
+     *
+     * This is what the residual and Jacobian callbacks of the derived fitters get passed.
+     * All arrays contain one entry per data point (peak), in the order of the traces.
+     */
+    struct ModelData
+    {
+      /// Number of data points
+      Size size;
+      /// Retention times of the peaks
+      std::vector<double> rt;
+      /// Observed intensities of the peaks
+      std::vector<double> intensity;
+      /// Theoretical intensity of the trace the peak belongs to
+      std::vector<double> theoretical_int;
+      /// Baseline of the mass traces
+      double baseline;
+    };
+
+    /**
+     * @brief Reusable workspace for the Levenberg-Marquardt optimization
+     *
+     * Keeps the GSL solvers (one per problem size) and the flattened data of the
+     * last fit, so that fitting many features does not allocate a new solver for
+     * every feature. A workspace must only be used by one fit at a time, i.e. use
+     * one workspace per thread.
+     */
+    class Workspace
+    {
+public:
+      /// default constructor
+      Workspace()
+      {
+      }
+
+      /// copy constructor (the solvers are not copied)
+      Workspace(const Workspace & /* source */)
+      {
+      }
+
+      /// assignment operator (keeps the own solvers)
+      Workspace & operator=(const Workspace & /* source */)
+      {
+        return *this;
+      }
+
+      /// destructor
+      ~Workspace()
+      {
+        clear();
+      }
+
+      /// Frees all solvers
+      void clear()
+      {
+        for (SolverMap::iterator it = solvers_.begin(); it != solvers_.end(); ++it)
+        {
+          gsl_multifit_fdfsolver_free(it->second);
+        }
+        solvers_.clear();
+      }
+
+      /// Returns a solver for @p data_count data points and @p num_params parameters (allocated on first use)
+      gsl_multifit_fdfsolver * getSolver(Size data_count, Size num_params)
+      {
+        std::pair<Size, Size> key(data_count, num_params);
+        SolverMap::iterator it = solvers_.find(key);
+        if (it != solvers_.end()) return it->second;
+
+        // keep the number of cached solvers bounded
+        if (solvers_.size() >= max_solvers_) clear();
+        gsl_multifit_fdfsolver * s = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, data_count, num_params);
+        solvers_[key] = s;
+        return s;
+      }
+
+      /// Flattened data of the current fit
+      ModelData data;
+
+protected:
+      typedef std::map<std::pair<Size, Size>, gsl_multifit_fdfsolver *> SolverMap;
+
+      /// Cached solvers by (data count, parameter count)
+      SolverMap solvers_;
+
+      /// Maximum number of cached solvers
+      static const Size max_solvers_ = 256;
+    };
+
     /// default constructor.
     TraceFitter() :
-      DefaultParamHandler("TraceFitter")
+      DefaultParamHandler("TraceFitter"),
+      workspace_(0)
     {
       this->defaults_.setValue("max_iteration", 500, "Maximum number of iterations using by Levenberg-Marquardt algorithm.", StringList::create("advanced"));
       this->defaults_.setValue("epsilon_abs", 0.0001, "Absolute error used by the Levenberg-Marquardt algorithm.", StringList::create("advanced"));
@@ -78,7 +176,8 @@ public:
       DefaultParamHandler(source),
       epsilon_abs_(source.epsilon_abs_),
       epsilon_rel_(source.epsilon_rel_),
-      max_iterations_(source.max_iterations_)
+      max_iterations_(source.max_iterations_),
+      workspace_(0)
     {
     }
 
@@ -104,6 +203,67 @@ public:
      */
     virtual void fit(FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> & traces) = 0;
 
+    /**
+     * @brief Fits many independent sets of mass traces in parallel
+     *
+     * @p fitters[i] is fitted to @p traces[i]. Each thread uses its own workspace.
+     *
+     * @param fitters The fitters (one per set of mass traces, the fitted models are stored in them)
+     * @param traces The sets of mass traces to fit
+     * @param success Contains for each set whether the fit was successful (the fitter threw no exception)
+     *
+     * @exception Exception::InvalidSize is thrown if @p fitters and @p traces differ in size
+     */
+    static void fitBatch(const std::vector<TraceFitter *> & fitters, std::vector<FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> > & traces, std::vector<bool> & success)
+    {
+      if (fitters.size() != traces.size())
+      {
+        throw Exception::InvalidSize(__FILE__, __LINE__, __PRETTY_FUNCTION__, traces.size());
+      }
+
+#ifdef _OPENMP
+      std::vector<Workspace> workspaces(omp_get_max_threads());
+#else
+      std::vector<Workspace> workspaces(1);
+#endif
+      // std::vector<bool> must not be written concurrently
+      std::vector<Int> fitted(traces.size(), 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)traces.size(); ++i)
+      {
+#ifdef _OPENMP
+        Workspace & workspace = workspaces[omp_get_thread_num()];
+#else
+        Workspace & workspace = workspaces[0];
+#endif
+        Workspace * previous = fitters[i]->workspace_;
+        fitters[i]->workspace_ = &workspace;
+        try
+        {
+          fitters[i]->fit(traces[i]);
+          fitted[i] = 1;
+        }
+        catch (Exception::BaseException &)
+        {
+          // the fit failed, this is reported in 'success'
+        }
+        fitters[i]->workspace_ = previous;
+      }
+      success.assign(fitted.begin(), fitted.end());
+    }
+
+    /**
+     * @brief Sets the workspace used by the optimization (not owned by the fitter)
+     *
+     * Passing 0 makes the fitter use its own workspace again.
+     */
+    void setWorkspace(Workspace * workspace)
+    {
+      workspace_ = workspace;
+    }
+
     /**
      * Returns the lower bound of the fitted RT model
      */
@@ -195,32 +355,50 @@ protected:
 
     /**
      * Optimize the given parameters using the Levenberg-Marquardt algorithm.
+     *
+     * The callbacks get a pointer to the ModelData of the workspace as parameter.
      */
     void optimize_(FeatureFinderAlgorithmPickedHelperStructs::MassTraces<PeakType> & traces, const Size num_params, double x_init[],
                    Int (* residual)(const gsl_vector * x, void * params, gsl_vector * f),
                    Int (* jacobian)(const gsl_vector * x, void * params, gsl_matrix * J),
                    Int (* evaluate)(const gsl_vector * x, void * params, gsl_vector * f, gsl_matrix * J))
     {
-      const gsl_multifit_fdfsolver_type * T;
-      gsl_multifit_fdfsolver * s;
-
       const size_t data_count = traces.getPeakCount();
 
       // gsl always expects N>=p or default gsl error handler invoked,
       // cause Jacobian be rectangular M x N with M>=N
       if (data_count < num_params) throw Exception::UnableToFit(__FILE__, __LINE__, __PRETTY_FUNCTION__, "UnableToFit-FinalSet", "Skipping feature, gsl always expects N>=p");
 
+      Workspace & workspace = (workspace_ != 0) ? *workspace_ : own_workspace_;
+
+      // flatten the mass traces for the callbacks (the vectors keep their capacity between fits)
+      ModelData & data = workspace.data;
+      data.size = data_count;
+      data.baseline = traces.baseline;
+      data.rt.resize(data_count);
+      data.intensity.resize(data_count);
+      data.theoretical_int.resize(data_count);
+      Size count = 0;
+      for (Size t = 0; t < traces.size(); ++t)
+      {
+        const FeatureFinderAlgorithmPickedHelperStructs::MassTrace<PeakType> & trace = traces[t];
+        for (Size i = 0; i < trace.peaks.size(); ++i, ++count)
+        {
+          data.rt[count] = trace.peaks[i].first;
+          data.intensity[count] = trace.peaks[i].second->getIntensity();
+          data.theoretical_int[count] = trace.theoretical_int;
+        }
+      }
+
       gsl_multifit_function_fdf func;
       gsl_vector_view x = gsl_vector_view_array(x_init, num_params);
-      gsl_rng_env_setup();
       func.f = (residual);
       func.df = (jacobian);
       func.fdf = (evaluate);
       func.n = data_count;
       func.p = num_params;
-      func.params = &traces;
-      T = gsl_multifit_fdfsolver_lmsder;
-      s = gsl_multifit_fdfsolver_alloc(T, data_count, num_params);
+      func.params = &data;
+      gsl_multifit_fdfsolver * s = workspace.getSolver(data_count, num_params);
       gsl_multifit_fdfsolver_set(s, &func, &x.vector);
       SignedSize iter = 0;
       Int gsl_status_;
@@ -236,8 +414,6 @@ protected:
 
       // get the parameters out of the fdfsolver
       getOptimizedParameters_(s);
-
-      gsl_multifit_fdfsolver_free(s);
     }
 
     /** Test for the convergence of the sequence by comparing the last iteration step dx with the absolute error epsabs and relative error epsrel to the current position x */
@@ -248,6 +424,11 @@ protected:
     /// Maximum number of iterations
     SignedSize max_iterations_;
 
+    /// Workspace set by the user (not owned, may be 0)
+    Workspace * workspace_;
+    /// Workspace used if no workspace was set
+    Workspace own_workspace_;
+
   };
 
 }
@@ -53,6 +53,8 @@ namespace OpenMS
     @brief This class computes the continuous wavelet transformation using a marr wavelet.
 
     The convolution of the signal and the wavelet is computed by numerical integration.
+    The raw data are copied into contiguous buffers before the transformation. These buffers
+    are kept between calls, so one transform object per thread can be reused for many spectra.
   */
   class OPENMS_DLLAPI ContinuousWaveletTransformNumIntegration :
     public ContinuousWaveletTransform
@@ -114,13 +116,20 @@ public:
 #ifdef DEBUG_PEAK_PICKING
         std::cout << "---------START TRANSFORM---------- \n";
 #endif
+        mz_buffer_.resize(n);
+        intensity_buffer_.resize(n);
         InputPeakIterator help = begin_input;
-        for (int i = 0; i < n; ++i)
+        for (SignedSize i = 0; i < n; ++i)
         {
-          signal_[i].setMZ(help->getMZ());
-          signal_[i].setIntensity((Peak1D::IntensityType)integrate_(help, begin_input, end_input));
+          mz_buffer_[i] = help->getMZ();
+          intensity_buffer_[i] = help->getIntensity();
           ++help;
         }
+        for (SignedSize i = 0; i < n; ++i)
+        {
+          signal_[i].setMZ(mz_buffer_[i]);
+          signal_[i].setIntensity((Peak1D::IntensityType)integrateBuffer_(i));
+        }
 #ifdef DEBUG_PEAK_PICKING
         std::cout << "---------END TRANSFORM----------" << std::endl;
 #endif
@@ -169,6 +178,9 @@ public:
           for (unsigned int i = 0; i < zeros; ++i) processed_input[n - zeros + i] = 0;
         }
 
+        // the data are equally spaced, so the wavelet values needed by the integration only depend on the distance in data points
+        resampleWavelet_(spacing);
+
         // TODO avoid to compute the cwt for the zeros in signal
         for (Int i = 0; i < n; ++i)
         {
@@ -316,15 +328,50 @@ protected:
       return v / sqrt(scale_);
     }
 
-    /// Computes the convolution of the wavelet and the raw data at position x with resolution > 1
+    /**
+        @brief Computes the convolution of the wavelet and the raw data at position x with resolution > 1
+
+        The wavelet has to be resampled to @p spacing_data by resampleWavelet_() before.
+    */
     double integrate_(const std::vector<double> & processed_input, double spacing_data, int index);
 
+    /**
+        @brief Computes the convolution of the wavelet and the buffered raw data at position @p index with resolution = 1
+
+        Gives the same result as the iterator version of integrate_(), but works on the contiguous buffers
+        and evaluates the wavelet only once per data point.
+    */
+    double integrateBuffer_(SignedSize index) const;
+
+    /// Tabulates the wavelet for equally spaced data with distance @p spacing_data
+    void resampleWavelet_(double spacing_data);
+
+    /// Returns the tabulated wavelet at distance @p distance from its center (nearest tabulated point)
+    inline double waveletAt_(double distance) const
+    {
+      Size index = (Size) Math::round(distance / spacing_);
+      if (index >= wavelet_.size())
+      {
+        index = wavelet_.size() - 1;
+      }
+      return wavelet_[index];
+    }
+
     /// Computes the marr wavelet at position x
     inline double marr_(double x)
     {
       return (1 - x * x) * exp(-x * x / 2);
     }
 
+    /// m/z positions of the raw data (resolution = 1)
+    std::vector<double> mz_buffer_;
+
+    /// Intensities of the raw data (resolution = 1)
+    std::vector<double> intensity_buffer_;
+
+    /// The wavelet tabulated at multiples of the data spacing (resolution > 1)
+    std::vector<double> resampled_wavelet_;
+
   };
 } //namespace OpenMS
 #endif
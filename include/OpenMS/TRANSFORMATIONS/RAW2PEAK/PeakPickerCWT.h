@@ -152,6 +152,12 @@ protected:
     /// Switch for the 2D optimization of peak parameters
     bool two_d_optimization_;
 
+    /// The minimal height which defines a peak in the CWT (MS 1 level), computed in updateMembers_()
+    DoubleReal peak_bound_cwt_;
+
+    /// The minimal height which defines a peak in the CWT (MS 2 level), computed in updateMembers_()
+    DoubleReal peak_bound_ms2_level_cwt_;
+
 
     void updateMembers_();
 
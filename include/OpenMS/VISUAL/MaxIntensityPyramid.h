@@ -0,0 +1,148 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2013.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_VISUAL_MAXINTENSITYPYRAMID_H
+#define OPENMS_VISUAL_MAXINTENSITYPYRAMID_H
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+      @brief Multi-resolution grid of maximum intensities of an LC-MS map.
+
+      The finest level bins the MS1 peaks of a map into a regular RT x m/z grid and stores the
+      maximum intensity of each bin. Each further level halves the resolution in both dimensions.
+      The maximum intensity of a large area can thus be looked up in a coarse level, instead of
+      visiting all peaks of that area.
+
+      Each level is split into square tiles, which are only allocated if they contain peaks.
+
+      @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI MaxIntensityPyramid
+  {
+public:
+    /// Default constructor
+    MaxIntensityPyramid();
+
+    /**
+        @brief Builds the pyramid from the MS1 spectra of @p exp
+
+        The ranges of @p exp have to be up to date (see MSExperiment::updateRanges()).
+
+        @param exp the LC-MS map
+        @param rt_bins number of bins of the finest level in RT dimension (at most one per MS1 spectrum is used)
+        @param mz_bins number of bins of the finest level in m/z dimension
+    */
+    void build(const MSExperiment<> & exp, Size rt_bins = 2048, Size mz_bins = 8192);
+
+    /// Removes all levels
+    void clear();
+
+    /// Returns if the pyramid is empty
+    bool empty() const;
+
+    /// Returns if the pyramid was built from @p exp and @p exp did not change its number of spectra or MS1 peaks since then
+    bool isBuiltFrom(const MSExperiment<> & exp) const;
+
+    /// Returns the number of levels
+    Size getLevelCount() const;
+
+    /// Returns the size of a bin in RT dimension of level @p level
+    DoubleReal getRTBinSize(Size level) const;
+
+    /// Returns the size of a bin in m/z dimension of level @p level
+    DoubleReal getMZBinSize(Size level) const;
+
+    /**
+        @brief Returns the coarsest level whose bins are not larger than @p rt_size x @p mz_size
+
+        Returns -1 if even the bins of the finest level are larger.
+    */
+    SignedSize getLevel(DoubleReal rt_size, DoubleReal mz_size) const;
+
+    /**
+        @brief Returns the maximum intensity of all bins of level @p level that overlap the given area
+
+        Returns -1 if there is no peak in these bins.
+
+        @exception Exception::IndexOverflow is thrown if @p level is not a valid level
+    */
+    Real getMaximum(Size level, DoubleReal rt_min, DoubleReal rt_max, DoubleReal mz_min, DoubleReal mz_max) const;
+
+protected:
+    /// One resolution level of the pyramid
+    struct Level_
+    {
+      /// number of bins in RT dimension
+      Size rt_bins;
+      /// number of bins in m/z dimension
+      Size mz_bins;
+      /// number of tiles in m/z dimension
+      Size mz_tiles;
+      /// tiles (row major, empty if the tile contains no peak)
+      std::vector<std::vector<Real> > tiles;
+
+      /// Returns the maximum of bin (@p rt, @p mz) or -1 if the bin is empty
+      Real get(Size rt, Size mz) const;
+
+      /// Sets bin (@p rt, @p mz) to the maximum of its current value and @p intensity
+      void update(Size rt, Size mz, Real intensity);
+    };
+
+    /// edge length of the tiles
+    static const Size TILE_SIZE = 64;
+
+    /// Initializes a level with the given number of bins
+    void initLevel_(Level_ & level, Size rt_bins, Size mz_bins) const;
+
+    /// the levels, starting with the finest one
+    std::vector<Level_> levels_;
+    /// RT range covered by the pyramid
+    DoubleReal rt_min_, rt_max_;
+    /// m/z range covered by the pyramid
+    DoubleReal mz_min_, mz_max_;
+    /// number of spectra of the map the pyramid was built from
+    Size spectrum_count_;
+    /// number of MS1 peaks of the map the pyramid was built from
+    Size peak_count_;
+  };
+
+}
+
+#endif // OPENMS_VISUAL_MAXINTENSITYPYRAMID_H
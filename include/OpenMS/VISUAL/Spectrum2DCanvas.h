@@ -39,8 +39,15 @@
 // OpenMS
 #include <OpenMS/VISUAL/SpectrumCanvas.h>
 #include <OpenMS/VISUAL/Spectrum1DCanvas.h>
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
 #include <OpenMS/KERNEL/PeakIndex.h>
 
+// Boost
+#include <boost/weak_ptr.hpp>
+
+// STL
+#include <map>
+
 // QT
 class QPainter;
 class QMouseEvent;
@@ -270,6 +277,12 @@ protected:
     /// RT projection data
     ExperimentType projection_rt_;
 
+    /// Maximum intensity pyramids of the peak layers, keyed by the peak data they were built from
+    std::map<const ExperimentType *, std::pair<boost::weak_ptr<ExperimentType>, MaxIntensityPyramid> > pyramids_;
+
+    /// Returns the maximum intensity pyramid of the peak layer @p layer_index (it is built if the peak data changed)
+    const MaxIntensityPyramid & getMaxIntensityPyramid_(Size layer_index);
+
     /**
       @brief Returns the position on color @p gradient associated with given intensity.
 
@@ -42,6 +42,7 @@
 
 #include <QtGui/QGraphicsScene>
 #include <QtCore/QProcess>
+#include <QtCore/QMap>
 
 namespace OpenMS
 {
@@ -79,6 +80,10 @@ public:
   Temporary files of the pipeline are stored in the member tmp_path_. Update it when loading a pipeline which has
   tmp data from an old run. TOPPASToolVertex will ask its parent scene() whenever it wants to know the tmp directory.
 
+      @todo Run supported tools in-process and hand over MSExperiment/FeatureMap/ConsensusMap objects between
+            vertices in memory instead of via temporary files. This needs the TOPPBase subclasses of the tools
+            in a library. It is a separate work item; only the thread budget (setThreadBalancing()) exists so far.
+
       @ingroup TOPPAS_elements
   */
   class OPENMS_GUI_DLLAPI TOPPASScene :
@@ -237,6 +242,18 @@ public:
     void setDescription(const QString & desc);
     /// sets the maximum number of jobs
     void setAllowedThreads(int num_threads);
+    /**
+      @brief Enables distribution of the allowed threads over concurrently runnable tools
+
+      If enabled, the number of allowed threads is treated as a budget of cores instead of a number of jobs.
+      Each tool process which is started receives the currently free cores, divided by the number of queued
+      processes whose inputs are ready, via its '-threads' parameter. These are processes of independent branches
+      of the workflow as well as further rounds of the same tool. The share is fixed when the process starts.
+      A linear part of the pipeline thus runs each tool with all cores, while ready processes run side by side.
+
+      All tools still run as separate processes and exchange data via files.
+    */
+    void setThreadBalancing(bool balance);
     /// returns the hovering edge
     TOPPASEdge* getHoveringEdge();
     /// Checks whether all output vertices are finished, and if yes, emits entirePipelineFinished() (called by finished output vertices)
@@ -268,8 +285,8 @@ public slots:
     void setPipelineRunning(bool b = true);
     /// Invoked by TTV or other vectices if a parameter was edited
     void changedParameter(const bool invalidates_running_pipeline);
-    /// Called by a finished QProcess to indicate that we are free to start a new one
-    void processFinished();
+    /// Called by a finished QProcess to indicate that we are free to start a new one. Releases the threads assigned to @p p.
+    void processFinished(QProcess * p = 0);
     /// dirty solution: when using ExecutePipeline this slot is called when the pipeline crashes. This will quit the app
     void quitWithError();
 
@@ -354,6 +371,10 @@ protected:
     QString description_text_;
     /// maximum number of allowed threads
     int allowed_threads_;
+    /// distribute allowed_threads_ over runnable tools via their '-threads' parameter
+    bool balance_threads_;
+    /// number of threads assigned to each running process
+    QMap<QProcess *, int> process_threads_;
     /// last node where 'resume' was started
     TOPPASToolVertex* resume_source_;
 
@@ -65,6 +65,7 @@ ColorSelector.h
 EnhancedTabBar.h
 HistogramWidget.h
 LayerData.h
+MaxIntensityPyramid.h
 MetaDataBrowser.h
 MultiGradient.h
 MultiGradientSelector.h
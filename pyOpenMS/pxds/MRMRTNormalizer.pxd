@@ -56,3 +56,18 @@ cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/MRMRTNormalizer.h>" namespace "Open
     bool chauvenet(libcpp_vector[double] residuals, int pos
                          ) nogil except + # wrap-attach:MRMRTNormalizer
 
+
+    # @brief This function removes outliers from a set of paired points using a
+    #  robust Theil-Sen line instead of iterative least squares fits.
+    #
+    # @return A vector of the remaining pairs (in the original order) is returned if
+    #  the R^2 limit was reached without reaching the coverage limit. If the limits
+    #  are reached, an exception is thrown.
+    #
+    # @exception Exception::UnableToFit is thrown if fitting cannot be performed
+    libcpp_vector[libcpp_pair[double,double]] rm_outliers_theil_sen(
+            libcpp_vector[libcpp_pair[double,double]] & pairs,
+            double rsq_limit,
+            double coverage_limit,
+            double outlier_threshold
+            ) nogil except + # wrap-attach:MRMRTNormalizer
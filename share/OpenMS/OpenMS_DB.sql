@@ -77,6 +77,24 @@ CREATE TABLE DATA_Peak (
 
 -- --------------------------------------------------------
 
+--
+-- Table structure for table `DATA_PeakArray`
+-- (all peaks of a spectrum as Base64 encoded, little endian arrays; alternative to DATA_Peak)
+--
+
+DROP TABLE IF EXISTS DATA_PeakArray;
+
+CREATE TABLE DATA_PeakArray (
+  fid_Spectrum bigint(20) unsigned NOT NULL default '0',
+  Size int(10) unsigned NOT NULL default '0',
+  Compressed tinyint(1) unsigned NOT NULL default '0',
+  mz longblob NOT NULL,
+  Intensity longblob NOT NULL,
+  PRIMARY KEY  (fid_Spectrum)
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+
+-- --------------------------------------------------------
+
 --
 -- Table structure for table `META_MetaInfoDescription`
 --
@@ -860,6 +878,12 @@ ALTER TABLE `DATA_Peak`
   ADD CONSTRAINT DATA_Peak_ibfk_1 FOREIGN KEY (fid_MetaInfo) REFERENCES META_MetaInfo (id) ON DELETE SET NULL ON UPDATE SET NULL,
   ADD CONSTRAINT Peak_ibfk_1 FOREIGN KEY (fid_Spectrum) REFERENCES DATA_Spectrum (id) ON DELETE CASCADE ON UPDATE CASCADE;
 
+--
+-- Constraints for table `DATA_PeakArray`
+--
+ALTER TABLE `DATA_PeakArray`
+  ADD CONSTRAINT DATA_PeakArray_ibfk_1 FOREIGN KEY (fid_Spectrum) REFERENCES DATA_Spectrum (id) ON DELETE CASCADE ON UPDATE CASCADE;
+
 --
 -- Constraints for table `DATA_PeakMetaData`
 --
@@ -1075,6 +1099,7 @@ ALTER TABLE `META_Software`
 -- Dumping data for table `ADMIN_Version`
 --
 
-INSERT INTO `ADMIN_Version` (`version`) VALUES ('$Revision$');
+-- schema revision, checked by DBAdapter::checkDBVersion() (increase it when the table structure changes)
+INSERT INTO `ADMIN_Version` (`version`) VALUES ('$Revision: 2 $');
 
 SET FOREIGN_KEY_CHECKS=1;
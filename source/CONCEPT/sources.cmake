@@ -10,6 +10,7 @@ FuzzyStringComparator.C
 LogStream.C
 LogConfigHandler.C
 GlobalExceptionHandler.C
+ParallelExceptionHandler.C
 ProgressLogger.C
 SingletonRegistry.C
 StreamHandler.C
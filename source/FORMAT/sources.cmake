@@ -22,6 +22,8 @@ FileHandler.C
 FileTypes.C
 GzipIfstream.C
 GzipInputStream.C
+HashingInputSource.C
+IdBinaryFile.C
 IdXMLFile.C
 IndexedMzMLFile.C
 InspectInfile.C
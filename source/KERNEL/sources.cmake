@@ -18,6 +18,7 @@ MRMTransitionGroup.C
 MSExperiment.C
 MSSpectrum.C
 OnDiscMSExperiment.C
+PeakArrayExperiment.C
 Peak1D.C
 Peak2D.C
 PeakIndex.C
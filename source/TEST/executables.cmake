@@ -10,6 +10,7 @@ set(concept_executables_list
 	VersionInfo_test
 	LogConfigHandler_test
 	LogStream_test
+	ParallelExceptionHandler_test
 	UnaryComposeFunctionAdapter_test
 	UniqueIdGenerator_test
 	UniqueIdIndexer_test
@@ -35,6 +36,7 @@ set(datastructures_executables_list
 	DefaultParamHandler_test
 	DistanceMatrix_test
 	DoubleList_test
+	FlatSet_test
 	GridFeature_test
 	HashGrid_test
 	IntList_test
@@ -121,6 +123,7 @@ set(kernel_executables_list
 	OnDiscMSExperiment_test
 	MSSpectrum_test
 	Peak1D_test
+	PeakArrayExperiment_test
 	Peak2D_test
 	PeakIndex_test
 	RangeUtils_test
@@ -131,6 +134,7 @@ set(kernel_executables_list
 
 set(visual_executables_list
   AxisTickCalculator_test
+  MaxIntensityPyramid_test
   MultiGradient_test
 )
 
@@ -153,6 +157,8 @@ set(format_executables_list
   FileTypes_test
   GzipIfstream_test
   GzipInputStream_test
+  HashingInputSource_test
+  IdBinaryFile_test
   IdXMLFile_test
   IndexedMzMLFile_test
   InspectInfile_test
@@ -10,6 +10,7 @@ ColorSelector.C
 EnhancedTabBar.C
 HistogramWidget.C
 LayerData.C
+MaxIntensityPyramid.C
 MetaDataBrowser.C
 MultiGradient.C
 MultiGradientSelector.C